@@ -8,6 +8,9 @@
 
 // Component includes (using paths relative to src/)
 #include "data/DataManager.h"
+#include "data/MergeCursor.h"
+#include "data/BarResampler.h"
+#include "data/ReplayCursor.h"
 #include "strategies/Strategy.h"
 
 // Standard library includes
@@ -28,15 +31,20 @@ private:
 
     // --- Core Components ---
     EventQueue event_queue_;
-    DataManager data_manager_; // Owns the data manager
+    ReplayCursor replay_; // Position in the shared dataset being replayed
+    std::unique_ptr<MergeCursor> market_feed_; // If set, replaces replay_ as the source of market data
     std::unique_ptr<Portfolio> portfolio_; // Owns the portfolio object
     std::unique_ptr<ExecutionHandler> execution_handler_; // Owns the execution handler
 
     // --- Runtime Variables ---
     std::vector<std::string> symbols_; // Symbols actually loaded from data
+    std::shared_ptr<const SymbolTable> symbol_table_; // IDs used by every event of this run
     std::chrono::system_clock::time_point current_time_; // Tracks simulation time
     bool continue_backtest_ = true; // Flag to control the main loop (now used correctly)
     long event_count_ = 0;          // Counter for processed events
+    std::shared_ptr<MarketEvent> market_event_; // Reused for every tick, see update_market_data
+    std::vector<Timeframe> timeframes_; // Strategy::required_timeframes()
+    std::vector<BarAggregator> aggregators_; // timeframes_.size() per SymbolId, see resample
     // Stores orders waiting for the next market tick to simulate execution
     std::map<std::chrono::system_clock::time_point, std::vector<EventPtr>> pending_orders_;
     // --- Risk Management Setting ---
@@ -54,7 +62,7 @@ public:
           initial_cash_(initial_cash),
           strategy_(std::move(strategy)), // Declaration order matched in initializer list
           minimum_equity_buffer_(min_equity_buffer)
-          // event_queue_, data_manager_ are default constructed
+          // event_queue_, replay_ are default constructed
     {
         // Initialize components dependent on others after the initializer list
         portfolio_ = std::make_unique<Portfolio>(initial_cash_);
@@ -69,7 +77,8 @@ public:
         }
     }
 
-    // Alternative constructor that accepts pre-loaded DataManager
+    // Alternative constructor that accepts pre-loaded DataManager. The loaded
+    // bars are shared, not copied: the Backtester only opens a replay cursor.
     Backtester(
         const DataManager& cached_data_manager,
         std::unique_ptr<Strategy> strategy, // Takes ownership of strategy
@@ -77,7 +86,7 @@ public:
         double min_equity_buffer = 1000.0) // Optional: Allow setting buffer
         : initial_cash_(initial_cash),
           strategy_(std::move(strategy)), // Declaration order matched in initializer list
-          data_manager_(cached_data_manager), // Copy the cached data manager
+          replay_(cached_data_manager.openReplay()),
           minimum_equity_buffer_(min_equity_buffer)
           // event_queue_ is default constructed
     {
@@ -94,6 +103,32 @@ public:
         }
     }
 
+    // Alternative constructor that streams market data from a merge cursor
+    // (e.g. over file- or network-backed BarStreams) instead of loaded data.
+    // The cursor is consumed, so such a Backtester can only run once.
+    Backtester(
+        std::unique_ptr<MergeCursor> market_feed,
+        std::unique_ptr<Strategy> strategy, // Takes ownership of strategy
+        double initial_cash = 100000.0,
+        double min_equity_buffer = 1000.0)
+        : initial_cash_(initial_cash),
+          strategy_(std::move(strategy)),
+          market_feed_(std::move(market_feed)),
+          minimum_equity_buffer_(min_equity_buffer)
+    {
+        portfolio_ = std::make_unique<Portfolio>(initial_cash_);
+        execution_handler_ = std::make_unique<ExecutionHandler>(event_queue_);
+
+        if (!market_feed_) {
+             throw std::runtime_error("Market feed provided to Backtester is null!");
+        }
+        if (strategy_) {
+             strategy_->set_portfolio(portfolio_.get());
+        } else {
+             throw std::runtime_error("Strategy provided to Backtester is null!");
+        }
+    }
+
     // --- Original Run Method (can keep or remove) ---
     void run() {
         if (!setup()) {
@@ -131,15 +166,25 @@ private:
 
         // Only load data if data_dir_ is set (first constructor)
         if (!data_dir_.empty()) {
-            data_manager_ = DataManager();
-            if (!data_manager_.loadData(data_dir_)) {
+            DataManager data_manager;
+            if (!data_manager.loadData(data_dir_)) {
                  std::cerr << "Failed to load market data from: " << data_dir_ << std::endl;
                  return false;
             }
+            replay_ = data_manager.openReplay(); // Keeps the dataset alive on its own
         }
-        // Otherwise, data_manager_ was already set in constructor (cached version)
+        // Otherwise, replay_ was already opened in constructor (cached version)
+        replay_.rewind();
 
-        symbols_ = data_manager_.getAllSymbols();
+        if (market_feed_) {
+            symbol_table_ = market_feed_->getSymbolTable();
+            symbols_ = symbol_table_->names();
+        } else if (replay_.dataset()) {
+            symbol_table_ = replay_.dataset()->symbolTable;
+            symbols_ = replay_.dataset()->symbols;
+        } else {
+            symbols_.clear();
+        }
         if (symbols_.empty()) {
              std::cerr << "No symbols loaded from data directory." << std::endl;
              return false;
@@ -148,7 +193,26 @@ private:
         for(const auto& s : symbols_) std::cout << s << " ";
         std::cout << std::endl;
 
-        current_time_ = data_manager_.getCurrentTime();
+        // Events carry SymbolIds from here on; names are only looked up for output.
+        portfolio_->set_symbol_table(symbol_table_.get());
+        execution_handler_->set_symbol_table(symbol_table_.get());
+        strategy_->set_symbol_table(symbol_table_.get());
+
+        timeframes_ = strategy_->required_timeframes();
+        aggregators_.clear();
+        if (!timeframes_.empty()) {
+            aggregators_.reserve(symbol_table_->size() * timeframes_.size());
+            for (size_t id = 0; id < symbol_table_->size(); ++id) {
+                for (const auto& timeframe : timeframes_) aggregators_.emplace_back(timeframe);
+            }
+        }
+
+        if (market_feed_) {
+            current_time_ = market_feed_->isFinished() ? std::chrono::system_clock::time_point::min()
+                                                       : market_feed_->peekNextTime();
+        } else {
+            current_time_ = replay_.getCurrentTime();
+        }
         if (current_time_ == std::chrono::system_clock::time_point::min()) {
              std::cerr << "Warning: Initial simulation time not set (no valid data found?)." << std::endl;
              return false;
@@ -180,7 +244,7 @@ private:
             }
 
             // Check termination condition
-            if (!processed_event_this_cycle && data_manager_.isDataFinished()) {
+            if (!processed_event_this_cycle && market_data_finished()) {
                  std::cout << "Termination condition met: Data finished and event queue exhausted for current time." << std::endl;
                  continue_backtest_ = false; // Set flag to exit loop
             }
@@ -190,16 +254,42 @@ private:
 
     // Fetches next market data snapshot and puts it on the event queue
     void update_market_data() {
-        if (!data_manager_.isDataFinished()) {
-            DataSnapshot snapshot = data_manager_.getNextBars();
-            if (!snapshot.empty()) {
-                auto market_timestamp = data_manager_.getCurrentTime();
-                EventPtr market_ev = std::make_shared<MarketEvent>(market_timestamp, std::move(snapshot));
-                event_queue_.push(std::move(market_ev));
+        if (!market_data_finished()) {
+            // The previous tick's event is refilled in place unless someone still holds it.
+            if (!market_event_ || market_event_.use_count() > 1) {
+                market_event_ = std::make_shared<MarketEvent>(std::chrono::system_clock::time_point{}, DataSnapshot{});
+            }
+            market_event_->resampled.clear();
+            const bool has_bars = market_feed_ ? market_feed_->getNextBars(market_event_->data)
+                                               : replay_.getNextBars(market_event_->data);
+            if (has_bars) {
+                market_event_->timestamp = market_feed_ ? market_feed_->getCurrentTime() : replay_.getCurrentTime();
+                if (!timeframes_.empty()) resample(*market_event_);
+                event_queue_.push(market_event_);
+            }
+        }
+    }
+
+    // Folds the tick's bars into the strategy's timeframes, O(1) per bar and
+    // timeframe; buckets completed by this tick ride on the event.
+    void resample(MarketEvent& event) {
+        const size_t perSymbol = timeframes_.size();
+        PriceBar completed;
+        for (const auto& [symbol, bar] : event.data) {
+            const size_t first = static_cast<size_t>(symbol) * perSymbol;
+            if (first + perSymbol > aggregators_.size()) continue; // Not in the table at setup
+            for (size_t k = 0; k < perSymbol; ++k) {
+                if (aggregators_[first + k].add(bar, completed)) {
+                    event.resampled.push_back({symbol, timeframes_[k], completed});
+                }
             }
         }
     }
 
+    bool market_data_finished() const {
+        return market_feed_ ? market_feed_->isFinished() : replay_.isFinished();
+    }
+
     // Routes events to the correct handlers based on type
     void handle_event(const EventPtr& event) {
         switch (event->type) {
@@ -218,7 +308,7 @@ private:
                 // Primarily informational, Portfolio/Risk would act on these in a real system
                 auto signal_event = std::dynamic_pointer_cast<SignalEvent>(event);
                 if(signal_event) {
-                    std::cout << "SIGNAL Received: " << signal_event->symbol << " "
+                    std::cout << "SIGNAL Received: " << symbol_label(symbol_table_.get(), signal_event->symbol) << " "
                            << (signal_event->direction == SignalDirection::LONG ? "LONG" : signal_event->direction == SignalDirection::SHORT ? "SHORT" : "FLAT")
                            << " @ " << formatTimestampUTC(signal_event->timestamp) << std::endl;
                 }
@@ -230,14 +320,14 @@ private:
                     // --- ADDED: Basic Equity Check Before Queuing Order ---
                     if (portfolio_ && portfolio_->get_total_equity() < minimum_equity_buffer_) {
                          std::cout << "ORDER REJECTED (Low Equity): Cannot queue order for "
-                                   << order_event->symbol << ". Equity " << portfolio_->get_total_equity()
+                                   << symbol_label(symbol_table_.get(), order_event->symbol) << ". Equity " << portfolio_->get_total_equity()
                                    << " < " << minimum_equity_buffer_ << std::endl;
                          break; // Discard order event, do not queue
                     }
                     // --- END Equity Check ---
 
                     // If equity check passes, queue the order
-                     std::cout << "ORDER Queued: " << order_event->symbol << " "
+                     std::cout << "ORDER Queued: " << symbol_label(symbol_table_.get(), order_event->symbol) << " "
                                << (order_event->direction == OrderDirection::BUY ? "BUY" : "SELL")
                                << " Qty: " << order_event->quantity
                                << " @ " << formatTimestampUTC(order_event->timestamp) << std::endl;
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "data/PriceBar.h"
+#include "core/SymbolTable.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+/**
+ * @brief The bars of one timestamp, stored flat by SymbolId.
+ *
+ * A dense array holds one bar slot per symbol and a bitmask records which
+ * slots are filled for the current tick. clear() only resets the bitmask, so
+ * a snapshot that is reused from tick to tick never allocates once it has
+ * been sized for the symbol table.
+ *
+ * Iteration visits the present symbols in increasing SymbolId order and
+ * yields {first: SymbolId, second: const PriceBar&} entries, so
+ *     for (const auto& [symbol, bar] : snapshot)
+ * works as it did with the map-based snapshot. Point lookups go through
+ * get(), which returns nullptr for a symbol without a bar at this tick.
+ */
+class DataSnapshot {
+public:
+    struct Entry {
+        SymbolId first;
+        const PriceBar& second;
+    };
+
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Entry;
+        using difference_type = std::ptrdiff_t;
+        using reference = Entry;
+        // it->second works like it did on the map iterator.
+        struct pointer {
+            Entry entry;
+            const Entry* operator->() const { return &entry; }
+        };
+
+        const_iterator(const DataSnapshot* owner, size_t word, uint64_t bits)
+            : owner_(owner), word_(word), bits_(bits) { skipEmptyWords(); }
+
+        Entry operator*() const { return {id(), owner_->bars_[id()]}; }
+        pointer operator->() const { return {**this}; }
+        const_iterator& operator++() {
+            bits_ &= bits_ - 1;
+            skipEmptyWords();
+            return *this;
+        }
+        const_iterator operator++(int) { const_iterator old = *this; ++*this; return old; }
+        bool operator==(const const_iterator& other) const { return word_ == other.word_ && bits_ == other.bits_; }
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+
+    private:
+        SymbolId id() const { return static_cast<SymbolId>(word_ * 64 + lowestBit(bits_)); }
+        void skipEmptyWords() {
+            while (bits_ == 0 && word_ + 1 < owner_->present_.size()) {
+                bits_ = owner_->present_[++word_];
+            }
+            if (bits_ == 0) word_ = owner_->present_.size(); // end()
+        }
+
+        const DataSnapshot* owner_;
+        size_t word_;
+        uint64_t bits_;
+    };
+
+    DataSnapshot() = default;
+    explicit DataSnapshot(size_t slots) { resize(slots); }
+
+    // Sizes the snapshot for SymbolIds [0, slots) and clears it.
+    void resize(size_t slots) {
+        bars_.assign(slots, PriceBar{});
+        present_.assign((slots + 63) / 64, 0);
+        count_ = 0;
+    }
+    size_t slots() const { return bars_.size(); }
+
+    void clear() {
+        if (count_ == 0) return;
+        std::fill(present_.begin(), present_.end(), 0);
+        count_ = 0;
+    }
+
+    // Stores the bar of `symbol`, growing the slot array if needed.
+    void set(SymbolId symbol, const PriceBar& bar) {
+        if (symbol >= bars_.size()) grow(size_t(symbol) + 1);
+        uint64_t& word = present_[symbol / 64];
+        const uint64_t bit = uint64_t(1) << (symbol % 64);
+        count_ += (word & bit) ? 0 : 1;
+        word |= bit;
+        bars_[symbol] = bar;
+    }
+
+    bool contains(SymbolId symbol) const {
+        return symbol < bars_.size() && (present_[symbol / 64] >> (symbol % 64) & 1) != 0;
+    }
+    const PriceBar* get(SymbolId symbol) const { return contains(symbol) ? &bars_[symbol] : nullptr; }
+
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+    const_iterator begin() const { return present_.empty() ? end() : const_iterator(this, 0, present_[0]); }
+    const_iterator end() const { return const_iterator(this, present_.size(), 0); }
+
+private:
+    static unsigned lowestBit(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(__builtin_ctzll(x));
+#else
+        unsigned n = 0;
+        while ((x & 1) == 0) { x >>= 1; ++n; }
+        return n;
+#endif
+    }
+
+    void grow(size_t slots) {
+        bars_.resize(slots);
+        present_.resize((slots + 63) / 64, 0);
+    }
+
+    std::vector<PriceBar> bars_;
+    std::vector<uint64_t> present_; // Bit i set = bars_[i] holds this tick's bar
+    size_t count_ = 0;
+};
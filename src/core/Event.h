@@ -1,6 +1,9 @@
 #pragma once
 
 #include "data/PriceBar.h" // Use path relative to src/ include dir
+#include "core/SymbolTable.h"
+#include "core/DataSnapshot.h" // Flat per-tick bar snapshot keyed by SymbolId
+#include "data/Timeframe.h"
 #include <vector>
 #include <string>
 #include <chrono>
@@ -8,11 +11,6 @@
 #include <map> // Using std::map for potentially ordered processing later
 #include <memory> // For std::shared_ptr
 
-// --- Define DataSnapshot consistently here ---
-// Use map for ordered iteration if needed, or std::unordered_map for performance
-using DataSnapshot = std::map<std::string, PriceBar>;
-
-
 // --- Event Types Enum ---
 enum class EventType {
     MARKET,
@@ -32,39 +30,48 @@ protected:
 };
 
 // --- Specific Event Structs ---
+// A higher-timeframe bar, stamped with its bucket start, that completed at
+// the tick of the MarketEvent carrying it.
+struct ResampledBar {
+    SymbolId symbol;
+    Timeframe timeframe;
+    PriceBar bar;
+};
+
 struct MarketEvent : public BaseEvent {
     DataSnapshot data;
+    std::vector<ResampledBar> resampled; // For the Strategy::required_timeframes() only
     MarketEvent(std::chrono::system_clock::time_point ts, DataSnapshot d)
         : BaseEvent(EventType::MARKET, ts), data(std::move(d)) {}
 };
 
 enum class SignalDirection { LONG, SHORT, FLAT };
 struct SignalEvent : public BaseEvent {
-    std::string symbol;
+    SymbolId symbol;
     SignalDirection direction;
-    SignalEvent(std::chrono::system_clock::time_point ts, std::string sym, SignalDirection dir)
-        : BaseEvent(EventType::SIGNAL, ts), symbol(std::move(sym)), direction(dir) {}
+    SignalEvent(std::chrono::system_clock::time_point ts, SymbolId sym, SignalDirection dir)
+        : BaseEvent(EventType::SIGNAL, ts), symbol(sym), direction(dir) {}
 };
 
 enum class OrderType { MARKET, LIMIT };
 enum class OrderDirection { BUY, SELL };
 struct OrderEvent : public BaseEvent {
-    std::string symbol;
+    SymbolId symbol;
     OrderType order_type;
     OrderDirection direction;
     double quantity;
-    OrderEvent(std::chrono::system_clock::time_point ts, std::string sym, OrderType type, OrderDirection dir, double qty)
-        : BaseEvent(EventType::ORDER, ts), symbol(std::move(sym)), order_type(type), direction(dir), quantity(qty) {}
+    OrderEvent(std::chrono::system_clock::time_point ts, SymbolId sym, OrderType type, OrderDirection dir, double qty)
+        : BaseEvent(EventType::ORDER, ts), symbol(sym), order_type(type), direction(dir), quantity(qty) {}
 };
 
 struct FillEvent : public BaseEvent {
-    std::string symbol;
+    SymbolId symbol;
     OrderDirection direction;
     double quantity;
     double fill_price;
     double commission = 0.0;
-    FillEvent(std::chrono::system_clock::time_point ts, std::string sym, OrderDirection dir, double qty, double price, double comm = 0.0)
-        : BaseEvent(EventType::FILL, ts), symbol(std::move(sym)), direction(dir), quantity(qty), fill_price(price), commission(comm) {}
+    FillEvent(std::chrono::system_clock::time_point ts, SymbolId sym, OrderDirection dir, double qty, double price, double comm = 0.0)
+        : BaseEvent(EventType::FILL, ts), symbol(sym), direction(dir), quantity(qty), fill_price(price), commission(comm) {}
 };
 
 // --- Event Pointer Alias ---
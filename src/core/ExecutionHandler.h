@@ -8,42 +8,46 @@
 #include <memory>
 #include <iostream> // For cout/cerr
 #include <algorithm> // For std::max, std::abs
+#include <cmath>     // For std::isnan
+#include <limits>
+#include <vector>
 
 class ExecutionHandler {
 private:
     EventQueue& event_queue_;
-    std::map<std::string, double> last_known_prices_; // Cache last prices for each symbol
+    std::vector<double> last_known_prices_; // Last price per SymbolId; NaN = none seen yet
+    const SymbolTable* symbol_table_ = nullptr; // Names for log output (non-owning)
 
 public:
     explicit ExecutionHandler(EventQueue& queue) : event_queue_(queue) {}
 
+    void set_symbol_table(const SymbolTable* symbols) { symbol_table_ = symbols; }
+
     void handle_order_event(const OrderEvent& order_event, const MarketEvent& next_market_event) {
         if (order_event.order_type == OrderType::MARKET) {
-            auto symbol_iter = next_market_event.data.find(order_event.symbol);
+            const PriceBar* next_bar = next_market_event.data.get(order_event.symbol);
             double fill_price = 0.0;
             bool can_fill = false;
             
-            if (symbol_iter != next_market_event.data.end()) {
+            if (next_bar) {
                 // Current market data available - use it
-                const PriceBar& next_bar = symbol_iter->second;
-                fill_price = next_bar.Open;
-                last_known_prices_[order_event.symbol] = fill_price; // Update cache
+                fill_price = next_bar->Open;
+                remember_price(order_event.symbol, fill_price); // Update cache
                 can_fill = true;
             } else {
                 // No current data - try to use last known price
-                auto last_price_iter = last_known_prices_.find(order_event.symbol);
-                if (last_price_iter != last_known_prices_.end()) {
-                    fill_price = last_price_iter->second;
+                if (order_event.symbol < last_known_prices_.size() && !std::isnan(last_known_prices_[order_event.symbol])) {
+                    fill_price = last_known_prices_[order_event.symbol];
                     can_fill = true;
                     std::cout << "SIM EXEC: Using last known price " << fill_price 
-                              << " for " << order_event.symbol << " (no current data)" << std::endl;
+                              << " for " << symbol_label(symbol_table_, order_event.symbol) << " (no current data)" << std::endl;
                 }
             }
 
             if (can_fill) {
                 double commission = calculate_commission(order_event.quantity, fill_price);
 
-                std::cout << "SIM EXEC: Order for " << order_event.quantity << " " << order_event.symbol
+                std::cout << "SIM EXEC: Order for " << order_event.quantity << " " << symbol_label(symbol_table_, order_event.symbol)
                           << (order_event.direction == OrderDirection::BUY ? " BUY" : " SELL")
                           << " filled at " << fill_price << std::endl;
 
@@ -57,7 +61,7 @@ public:
                 );
                 event_queue_.push(std::move(fill_ev));
             } else {
-                std::cerr << "SIM EXEC WARN: No market data or last known price for " << order_event.symbol
+                std::cerr << "SIM EXEC WARN: No market data or last known price for " << symbol_label(symbol_table_, order_event.symbol)
                           << " at " << formatTimestampUTC(next_market_event.timestamp) 
                           << " to fill order." << std::endl;
             }
@@ -69,11 +73,18 @@ public:
     // Method to update price cache from market events (call from Backtester)
     void update_price_cache(const MarketEvent& market_event) {
         for (const auto& pair : market_event.data) {
-            last_known_prices_[pair.first] = pair.second.Close;
+            remember_price(pair.first, pair.second.Close);
         }
     }
 
 private:
+    void remember_price(SymbolId symbol, double price) {
+        if (symbol >= last_known_prices_.size()) {
+            last_known_prices_.resize(size_t(symbol) + 1, std::numeric_limits<double>::quiet_NaN());
+        }
+        last_known_prices_[symbol] = price;
+    }
+
     // Example commission calculation
     double calculate_commission(double quantity, double price) {
         // Suppress warning if price is not used in this simple model
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Resolves a requested worker count: 0 means "use all hardware threads".
+inline size_t resolve_thread_count(size_t requested) {
+    if (requested != 0) return requested;
+    unsigned int hw = std::thread::hardware_concurrency();
+    return hw == 0 ? 1 : static_cast<size_t>(hw);
+}
+
+// Runs task(i) for every i in [0, count) on up to `threads` workers.
+// Work is handed out through a shared counter, so tasks of uneven cost balance
+// naturally. With a single worker (or a single task) everything runs inline on
+// the calling thread. The first exception thrown by any task is rethrown here
+// once all workers have stopped.
+inline void parallel_for(size_t count, size_t threads, const std::function<void(size_t)>& task) {
+    if (count == 0) return;
+    threads = std::min(resolve_thread_count(threads), count);
+    if (threads <= 1) {
+        for (size_t i = 0; i < count; ++i) task(i);
+        return;
+    }
+
+    std::atomic<size_t> next{0};
+    std::exception_ptr first_error;
+    std::mutex error_mutex;
+
+    auto worker = [&]() {
+        for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+            try {
+                task(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!first_error) first_error = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (size_t t = 1; t < threads; ++t) pool.emplace_back(worker);
+    worker(); // The calling thread takes a share of the work too
+    for (auto& th : pool) th.join();
+
+    if (first_error) std::rethrow_exception(first_error);
+}
+
+// A fixed set of worker threads running submitted tasks in submission order.
+// Tasks must not block waiting for other tasks and must not throw. The
+// destructor runs the tasks still queued, then joins the workers.
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threads) {
+        threads = resolve_thread_count(threads);
+        workers_.reserve(threads);
+        for (size_t t = 0; t < threads; ++t) workers_.emplace_back([this] { run(); });
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto& worker : workers_) worker.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return workers_.size(); }
+
+    void submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.push_back(std::move(task));
+        }
+        wake_.notify_one();
+    }
+
+private:
+    void run() {
+        for (;;) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+            if (tasks_.empty()) return;
+            std::function<void()> task = std::move(tasks_.front());
+            tasks_.pop_front();
+            lock.unlock();
+            task();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<std::function<void()>> tasks_;
+    bool stop_ = false;
+    std::vector<std::thread> workers_;
+};
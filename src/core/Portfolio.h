@@ -38,7 +38,8 @@ public: // Make Position public so methods can access it easily
 private:
     double initial_cash_ = 100000.0;
     double current_cash_ = 0.0;
-    std::map<std::string, Position> positions_;
+    std::vector<Position> positions_; // Indexed by SymbolId, grown on first fill
+    const SymbolTable* symbol_table_ = nullptr; // Names for log output (non-owning)
     double total_commission_ = 0.0;
     double realized_pnl_ = 0.0;
     long num_fills_ = 0;
@@ -48,12 +49,15 @@ public:
     explicit Portfolio(double initial_cash = 100000.0)
         : initial_cash_(initial_cash), current_cash_(initial_cash) {}
 
+    void set_symbol_table(const SymbolTable* symbols) { symbol_table_ = symbols; }
+
     // --- handle_fill_event, update_market_values, record_equity ---
     // --- (same as previous correct version) ---
     void handle_fill_event(const FillEvent& event) {
         num_fills_++;
         total_commission_ += event.commission;
         current_cash_ -= event.commission;
+        if (event.symbol >= positions_.size()) positions_.resize(size_t(event.symbol) + 1);
         Position& pos = positions_[event.symbol];
         double position_change_value = event.quantity * event.fill_price;
         double previous_quantity = pos.quantity;
@@ -90,33 +94,27 @@ public:
                  pos.average_price = event.fill_price;
              }
         }
-        std::cout << "PORTFOLIO: Fill - Sym: " << event.symbol << ", Dir: " << (event.direction == OrderDirection::BUY ? "BUY" : "SELL") << ", Qty: " << event.quantity << " @ " << event.fill_price << ", NewPos: " << pos.quantity << ", AvgPx: " << pos.average_price << ", Cash: " << current_cash_ << std::endl;
-        update_market_values({{event.symbol, PriceBar{event.timestamp, 0,0,0, event.fill_price, 0}}});
+        std::cout << "PORTFOLIO: Fill - Sym: " << symbol_label(symbol_table_, event.symbol) << ", Dir: " << (event.direction == OrderDirection::BUY ? "BUY" : "SELL") << ", Qty: " << event.quantity << " @ " << event.fill_price << ", NewPos: " << pos.quantity << ", AvgPx: " << pos.average_price << ", Cash: " << current_cash_ << std::endl;
+        update_market_value(pos, event.fill_price);
         record_equity(event.timestamp);
     }
 
     void update_market_values(const DataSnapshot& current_data) {
-        for (auto& pair : positions_) {
-            const std::string& symbol = pair.first;
-            Position& pos = pair.second;
+        for (SymbolId symbol = 0; symbol < positions_.size(); ++symbol) {
+            Position& pos = positions_[symbol];
             if (std::abs(pos.quantity) < 1e-9) {
-                pos.market_value = 0.0;
-                pos.unrealized_pnl = 0.0;
+                update_market_value(pos, 0.0);
                 continue;
             }
-            auto it = current_data.find(symbol);
-            if (it != current_data.end()) {
-                double current_price = it->second.Close;
-                pos.market_value = pos.quantity * current_price;
-                double cost_basis = pos.quantity * pos.average_price;
-                pos.unrealized_pnl = pos.market_value - cost_basis;
+            if (const PriceBar* bar = current_data.get(symbol)) {
+                update_market_value(pos, bar->Close);
             }
         }
     }
 
      void record_equity(const std::chrono::system_clock::time_point& timestamp) {
          double total_market_value = 0.0;
-         for(const auto& pair : positions_) { total_market_value += pair.second.market_value; }
+         for(const auto& pos : positions_) { total_market_value += pos.market_value; }
          double total_equity = current_cash_ + total_market_value;
          if (equity_curve_.empty() || equity_curve_.back().first != timestamp) {
               equity_curve_.emplace_back(timestamp, total_equity);
@@ -129,15 +127,15 @@ public:
     double get_current_cash() const { return current_cash_; }
     double get_total_equity() const {
          double total_market_value = 0.0;
-         for(const auto& pair : positions_) { total_market_value += pair.second.market_value; }
+         for(const auto& pos : positions_) { total_market_value += pos.market_value; }
         return current_cash_ + total_market_value;
     }
-    const std::map<std::string, Position>& get_positions() const { return positions_; }
+    // Indexed by SymbolId; symbols that never traded may be missing from the end.
+    const std::vector<Position>& get_positions() const { return positions_; }
     const std::vector<std::pair<std::chrono::system_clock::time_point, double>>& get_equity_curve() const { return equity_curve_; }
     double get_total_commission() const { return total_commission_; }
-    double get_position_quantity(const std::string& symbol) const {
-         auto it = positions_.find(symbol);
-         return (it != positions_.end()) ? it->second.quantity : 0.0;
+    double get_position_quantity(SymbolId symbol) const {
+         return symbol < positions_.size() ? positions_[symbol].quantity : 0.0;
      }
 
     // --- Calculate and Print Performance Metrics ---
@@ -175,21 +173,22 @@ public:
         std::cout << "Ending Cash:     " << current_cash_ << std::endl;
          double total_market_value = 0.0;
          double total_unrealized_pnl = 0.0;
-         for(const auto& pair : positions_) {
-             total_market_value += pair.second.market_value;
-             total_unrealized_pnl += pair.second.unrealized_pnl;
+         for(const auto& pos : positions_) {
+             total_market_value += pos.market_value;
+             total_unrealized_pnl += pos.unrealized_pnl;
          }
         std::cout << "Market Value:    " << total_market_value << std::endl;
         std::cout << "Unrealized PnL:  " << total_unrealized_pnl << std::endl;
         std::cout << "Ending Positions:" << std::endl;
         bool has_positions = false;
-        for (const auto& pair : positions_) {
-            if (std::abs(pair.second.quantity) > 1e-9) {
+        for (SymbolId symbol = 0; symbol < positions_.size(); ++symbol) {
+            const Position& pos = positions_[symbol];
+            if (std::abs(pos.quantity) > 1e-9) {
                 has_positions = true;
-                std::cout << "  " << std::left << std::setw(30) << pair.first << ": "
-                          << std::right << std::setw(10) << pair.second.quantity
-                          << " @ Avg Cost " << std::setw(8) << pair.second.average_price
-                          << " (MV: " << pair.second.market_value << ", UPL: " << pair.second.unrealized_pnl << ")"
+                std::cout << "  " << std::left << std::setw(30) << symbol_label(symbol_table_, symbol) << ": "
+                          << std::right << std::setw(10) << pos.quantity
+                          << " @ Avg Cost " << std::setw(8) << pos.average_price
+                          << " (MV: " << pos.market_value << ", UPL: " << pos.unrealized_pnl << ")"
                           << std::endl;
             }
         }
@@ -229,4 +228,16 @@ public:
 
         return res;
     }
+private:
+    // Marks one position to `price`; flat positions are valued at zero.
+    static void update_market_value(Position& pos, double price) {
+        if (std::abs(pos.quantity) < 1e-9) {
+            pos.market_value = 0.0;
+            pos.unrealized_pnl = 0.0;
+            return;
+        }
+        pos.market_value = pos.quantity * price;
+        double cost_basis = pos.quantity * pos.average_price;
+        pos.unrealized_pnl = pos.market_value - cost_basis;
+    }
 }; // End of Portfolio class definition
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Dense integer handle for a symbol. IDs are issued 0, 1, 2, ... by a
+// SymbolTable and can index plain arrays.
+using SymbolId = uint32_t;
+constexpr SymbolId INVALID_SYMBOL_ID = std::numeric_limits<SymbolId>::max();
+
+/**
+ * @brief Interning table mapping symbol names to dense SymbolIds.
+ *
+ * DataManager builds one per load (in sorted name order, so iterating IDs in
+ * increasing order visits symbols alphabetically) and hands it to the rest of
+ * the pipeline. Events, the portfolio and the execution handler work with
+ * SymbolIds only; names are looked up here for logging and reporting.
+ */
+class SymbolTable {
+public:
+    // Returns the ID of `name`, assigning the next free ID on first use.
+    SymbolId intern(const std::string& name) {
+        auto it = ids_.find(name);
+        if (it != ids_.end()) return it->second;
+        const SymbolId id = static_cast<SymbolId>(names_.size());
+        names_.push_back(name);
+        ids_.emplace(name, id);
+        return id;
+    }
+
+    // INVALID_SYMBOL_ID if `name` has not been interned.
+    SymbolId find(const std::string& name) const {
+        auto it = ids_.find(name);
+        return it != ids_.end() ? it->second : INVALID_SYMBOL_ID;
+    }
+
+    const std::string& name(SymbolId id) const {
+        if (id >= names_.size()) {
+            throw std::out_of_range("SymbolTable: unknown symbol id " + std::to_string(id));
+        }
+        return names_[id];
+    }
+
+    bool contains(SymbolId id) const { return id < names_.size(); }
+    size_t size() const { return names_.size(); }
+    bool empty() const { return names_.empty(); }
+    const std::vector<std::string>& names() const { return names_; }
+
+private:
+    std::vector<std::string> names_;
+    std::unordered_map<std::string, SymbolId> ids_;
+};
+
+// Name of `id` for log output; falls back to "#<id>" without a table or for unknown IDs.
+inline std::string symbol_label(const SymbolTable* table, SymbolId id) {
+    if (table && table->contains(id)) return table->name(id);
+    return "#" + std::to_string(id);
+}
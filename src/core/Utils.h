@@ -9,6 +9,9 @@
 #include <deque>
 #include <algorithm>
 #include <iterator>
+#include <cmath>
+#include <numeric>
+#include <random>
 
 // Simple circular buffer replacement for boost::circular_buffer
 template<typename T>
@@ -163,4 +166,44 @@ inline std::string formatTimestampUTC(const std::chrono::system_clock::time_poin
     return ss.str();
 }
 
+// Spearman rank correlation of two equally long samples (ties get their average
+// rank); NaN for fewer than two values or when either sample is constant.
+inline double rank_correlation(const std::vector<double>& a, const std::vector<double>& b) {
+    auto ranks = [](const std::vector<double>& values) {
+        std::vector<size_t> order(values.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](size_t x, size_t y) { return values[x] < values[y]; });
+        std::vector<double> rank(values.size());
+        for (size_t i = 0; i < order.size();) {
+            size_t j = i;
+            while (j + 1 < order.size() && values[order[j + 1]] == values[order[i]]) ++j;
+            for (size_t k = i; k <= j; ++k) rank[order[k]] = (i + j) / 2.0 + 1.0;
+            i = j + 1;
+        }
+        return rank;
+    };
+    if (a.size() != b.size() || a.size() < 2) return std::nan("");
+    const std::vector<double> ra = ranks(a), rb = ranks(b);
+    const double mean = (a.size() + 1) / 2.0;
+    double cov = 0.0, va = 0.0, vb = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        cov += (ra[i] - mean) * (rb[i] - mean);
+        va += (ra[i] - mean) * (ra[i] - mean);
+        vb += (rb[i] - mean) * (rb[i] - mean);
+    }
+    return va > 0.0 && vb > 0.0 ? cov / std::sqrt(va * vb) : std::nan("");
+}
+
+// `count` distinct indices drawn uniformly from [0, population), in ascending
+// order (all of them if count >= population). The same seed draws the same sample.
+inline std::vector<size_t> random_sample_indices(size_t population, size_t count, unsigned seed) {
+    std::vector<size_t> indices(population);
+    std::iota(indices.begin(), indices.end(), 0);
+    std::mt19937 rng(seed);
+    std::shuffle(indices.begin(), indices.end(), rng);
+    indices.resize(std::min(count, population));
+    std::sort(indices.begin(), indices.end());
+    return indices;
+}
+
 // You can add other common utility functions here later
\ No newline at end of file
@@ -0,0 +1,298 @@
+#include "BarCache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// "TSBARCOL" read as a native little-endian word; a byte-swapped file fails the check.
+constexpr uint64_t CACHE_MAGIC = 0x4C4F435241425354ULL;
+constexpr size_t COLUMN_COUNT = 6; // timestamp, open, high, low, close, volume
+constexpr size_t COLUMN_ALIGNMENT = 64;
+
+constexpr uint32_t FLAG_SOURCE_IN_ORDER = 1u << 0;
+
+// Checksum sampling: the head and tail of the file plus evenly spaced blocks in between.
+constexpr size_t SAMPLE_BLOCK_BYTES = 4096;
+constexpr size_t SAMPLE_BLOCKS = 16;
+
+struct CacheHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t headerSize;
+    int64_t clockNum;           // system_clock::period of the timestamp column
+    int64_t clockDen;
+    int64_t utcOffsetSeconds;
+    uint64_t sourceSize;
+    int64_t sourceMtime;
+    uint64_t sourceChecksum;
+    uint64_t rowCount;
+    int64_t minTime;
+    int64_t maxTime;
+    uint32_t flags;
+    uint32_t messageCount;
+    uint64_t columnOffsets[COLUMN_COUNT];
+    uint64_t messagesOffset;
+    uint64_t messagesBytes;
+    uint64_t fileSize;
+};
+
+size_t alignUp(size_t value) {
+    return (value + COLUMN_ALIGNMENT - 1) / COLUMN_ALIGNMENT * COLUMN_ALIGNMENT;
+}
+
+uint64_t mixChecksum(uint64_t hash, const char* data, size_t len) {
+    constexpr uint64_t PRIME = 0x100000001B3ULL;
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        hash = (hash ^ word) * PRIME;
+        hash ^= hash >> 29;
+    }
+    for (; i < len; ++i) {
+        hash = (hash ^ static_cast<unsigned char>(data[i])) * PRIME;
+    }
+    return hash;
+}
+
+bool writeAll(std::ofstream& out, const void* data, size_t len) {
+    out.write(static_cast<const char*>(data), static_cast<std::streamsize>(len));
+    return static_cast<bool>(out);
+}
+
+bool writePadding(std::ofstream& out, size_t from, size_t to) {
+    static const char zeros[COLUMN_ALIGNMENT] = {};
+    return to <= from || writeAll(out, zeros, to - from);
+}
+
+} // namespace
+
+BarCache::SourceStamp BarCache::stampSource(const std::string& path, const char* data, size_t size) {
+    SourceStamp stamp;
+    stamp.size = size;
+    std::error_code ec;
+    auto mtime = fs::last_write_time(path, ec);
+    stamp.mtime = ec ? 0 : static_cast<int64_t>(mtime.time_since_epoch().count());
+
+    // Hashing every byte would cost as much as reading the CSV; size + mtime
+    // catch ordinary edits, the sampled checksum catches copies and restores.
+    uint64_t hash = 0xCBF29CE484222325ULL ^ size;
+    if (size <= SAMPLE_BLOCK_BYTES * (SAMPLE_BLOCKS + 2)) {
+        hash = mixChecksum(hash, data, size);
+    } else {
+        hash = mixChecksum(hash, data, SAMPLE_BLOCK_BYTES);
+        const size_t span = size - 2 * SAMPLE_BLOCK_BYTES;
+        for (size_t i = 1; i <= SAMPLE_BLOCKS; ++i) {
+            size_t offset = SAMPLE_BLOCK_BYTES + span * i / (SAMPLE_BLOCKS + 1) - SAMPLE_BLOCK_BYTES / 2;
+            hash = mixChecksum(hash, data + offset, SAMPLE_BLOCK_BYTES);
+        }
+        hash = mixChecksum(hash, data + size - SAMPLE_BLOCK_BYTES, SAMPLE_BLOCK_BYTES);
+    }
+    stamp.checksum = hash;
+    return stamp;
+}
+
+std::string BarCache::cachePathFor(const std::string& cacheDir, const std::string& sourcePath) {
+    return (fs::path(cacheDir) / (fs::path(sourcePath).filename().string() + ".bars")).string();
+}
+
+bool BarCache::write(const std::string& cachePath, const SourceStamp& source, std::chrono::seconds utcOffset,
+                     const std::vector<PriceBar>& bars, bool sourceInOrder,
+                     const std::vector<Message>& messages, std::string& error) {
+    const fs::path target(cachePath);
+    std::error_code ec;
+    if (target.has_parent_path()) {
+        fs::create_directories(target.parent_path(), ec);
+        if (ec) {
+            error = "cannot create " + target.parent_path().string() + ": " + ec.message();
+            return false;
+        }
+    }
+
+    CacheHeader header{};
+    header.magic = CACHE_MAGIC;
+    header.version = FORMAT_VERSION;
+    header.headerSize = sizeof(CacheHeader);
+    header.clockNum = std::chrono::system_clock::period::num;
+    header.clockDen = std::chrono::system_clock::period::den;
+    header.utcOffsetSeconds = utcOffset.count();
+    header.sourceSize = source.size;
+    header.sourceMtime = source.mtime;
+    header.sourceChecksum = source.checksum;
+    header.rowCount = bars.size();
+    header.minTime = bars.empty() ? 0 : bars.front().timestamp.time_since_epoch().count();
+    header.maxTime = bars.empty() ? 0 : bars.back().timestamp.time_since_epoch().count();
+    header.flags = sourceInOrder ? FLAG_SOURCE_IN_ORDER : 0;
+    header.messageCount = static_cast<uint32_t>(messages.size());
+
+    const size_t columnBytes = bars.size() * sizeof(int64_t);
+    size_t offset = alignUp(sizeof(CacheHeader));
+    for (size_t c = 0; c < COLUMN_COUNT; ++c) {
+        header.columnOffsets[c] = offset;
+        offset = alignUp(offset + columnBytes);
+    }
+    header.messagesOffset = offset;
+    for (const auto& message : messages) {
+        header.messagesBytes += 1 + sizeof(uint32_t) + message.text.size();
+    }
+    header.fileSize = header.messagesOffset + header.messagesBytes;
+
+    // Unique per writer so concurrent processes never share a temporary file.
+    const std::string tempPath = cachePath + ".tmp" +
+        std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()) ^
+                       static_cast<size_t>(std::chrono::steady_clock::now().time_since_epoch().count()));
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            error = "cannot open " + tempPath + " for writing";
+            return false;
+        }
+        bool ok = writeAll(out, &header, sizeof(header)) &&
+                  writePadding(out, sizeof(header), header.columnOffsets[0]);
+
+        // One column at a time through a reusable buffer of 8-byte values.
+        std::vector<char> column(columnBytes);
+        for (size_t c = 0; ok && c < COLUMN_COUNT; ++c) {
+            char* dst = column.data();
+            for (const auto& bar : bars) {
+                switch (c) {
+                    case 0: { int64_t v = bar.timestamp.time_since_epoch().count(); std::memcpy(dst, &v, 8); break; }
+                    case 1: std::memcpy(dst, &bar.Open, 8); break;
+                    case 2: std::memcpy(dst, &bar.High, 8); break;
+                    case 3: std::memcpy(dst, &bar.Low, 8); break;
+                    case 4: std::memcpy(dst, &bar.Close, 8); break;
+                    default: { int64_t v = bar.Volume; std::memcpy(dst, &v, 8); break; }
+                }
+                dst += 8;
+            }
+            const size_t columnEnd = header.columnOffsets[c] + columnBytes;
+            const size_t nextStart = c + 1 < COLUMN_COUNT ? header.columnOffsets[c + 1] : header.messagesOffset;
+            ok = writeAll(out, column.data(), columnBytes) && writePadding(out, columnEnd, nextStart);
+        }
+
+        for (size_t i = 0; ok && i < messages.size(); ++i) {
+            const uint8_t isError = messages[i].is_error ? 1 : 0;
+            const uint32_t length = static_cast<uint32_t>(messages[i].text.size());
+            ok = writeAll(out, &isError, 1) && writeAll(out, &length, sizeof(length)) &&
+                 writeAll(out, messages[i].text.data(), length);
+        }
+        out.close();
+        if (!ok || !out) {
+            fs::remove(tempPath, ec);
+            error = "write to " + tempPath + " failed";
+            return false;
+        }
+    }
+
+    fs::rename(tempPath, target, ec);
+    if (ec) {
+        std::error_code ignored;
+        fs::remove(tempPath, ignored);
+        error = "cannot rename " + tempPath + ": " + ec.message();
+        return false;
+    }
+    return true;
+}
+
+bool BarCache::open(const std::string& cachePath, const SourceStamp& source, std::chrono::seconds utcOffset) {
+    std::error_code ec;
+    if (!fs::is_regular_file(cachePath, ec)) return false;
+    mapped_.map(cachePath, ec);
+    if (ec || !mapped_.is_mapped() || mapped_.size() < sizeof(CacheHeader)) {
+        mapped_.unmap();
+        return false;
+    }
+
+    CacheHeader header;
+    std::memcpy(&header, mapped_.data(), sizeof(header));
+    const size_t columnBytes = header.rowCount * sizeof(int64_t);
+    bool valid = header.magic == CACHE_MAGIC &&
+                 header.version == FORMAT_VERSION &&
+                 header.headerSize == sizeof(CacheHeader) &&
+                 header.clockNum == std::chrono::system_clock::period::num &&
+                 header.clockDen == std::chrono::system_clock::period::den &&
+                 header.utcOffsetSeconds == utcOffset.count() &&
+                 header.sourceSize == source.size &&
+                 header.sourceMtime == source.mtime &&
+                 header.sourceChecksum == source.checksum &&
+                 header.fileSize == mapped_.size() &&
+                 header.rowCount <= mapped_.size() / sizeof(int64_t) &&
+                 header.messagesOffset + header.messagesBytes <= mapped_.size();
+    for (size_t c = 0; valid && c < COLUMN_COUNT; ++c) {
+        valid = header.columnOffsets[c] % COLUMN_ALIGNMENT == 0 &&
+                header.columnOffsets[c] + columnBytes <= header.messagesOffset;
+    }
+
+    std::vector<Message> messages;
+    if (valid) {
+        const char* p = mapped_.data() + header.messagesOffset;
+        const char* end = p + header.messagesBytes;
+        for (uint32_t i = 0; valid && i < header.messageCount; ++i) {
+            uint32_t length = 0;
+            if (end - p < static_cast<std::ptrdiff_t>(1 + sizeof(length))) { valid = false; break; }
+            Message message;
+            message.is_error = *p != 0;
+            std::memcpy(&length, p + 1, sizeof(length));
+            p += 1 + sizeof(length);
+            if (static_cast<size_t>(end - p) < length) { valid = false; break; }
+            message.text.assign(p, length);
+            p += length;
+            messages.push_back(std::move(message));
+        }
+    }
+    if (!valid) {
+        mapped_.unmap();
+        return false;
+    }
+
+    // mmap returns page-aligned memory and every column starts on a 64-byte boundary.
+    const char* base = mapped_.data();
+    rows_ = header.rowCount;
+    sourceInOrder_ = (header.flags & FLAG_SOURCE_IN_ORDER) != 0;
+    minTime_ = header.minTime;
+    maxTime_ = header.maxTime;
+    messages_ = std::move(messages);
+    timestamps_ = reinterpret_cast<const int64_t*>(base + header.columnOffsets[0]);
+    open_ = reinterpret_cast<const double*>(base + header.columnOffsets[1]);
+    high_ = reinterpret_cast<const double*>(base + header.columnOffsets[2]);
+    low_ = reinterpret_cast<const double*>(base + header.columnOffsets[3]);
+    close_ = reinterpret_cast<const double*>(base + header.columnOffsets[4]);
+    volume_ = reinterpret_cast<const int64_t*>(base + header.columnOffsets[5]);
+    return true;
+}
+
+void BarCache::appendBars(std::vector<PriceBar>& out, size_t maxRows) const {
+    appendRows(out, 0, std::min(rows_, maxRows));
+}
+
+void BarCache::appendBarsInRange(std::vector<PriceBar>& out, std::chrono::system_clock::time_point start,
+                                 std::chrono::system_clock::time_point end) const {
+    const size_t first = lowerBound(start);
+    appendRows(out, first, std::max(first, lowerBound(end)));
+}
+
+size_t BarCache::lowerBound(std::chrono::system_clock::time_point t) const {
+    const int64_t ticks = t.time_since_epoch().count();
+    return static_cast<size_t>(std::lower_bound(timestamps_, timestamps_ + rows_, ticks) - timestamps_);
+}
+
+void BarCache::appendRows(std::vector<PriceBar>& out, size_t first, size_t last) const {
+    out.reserve(out.size() + (last - first));
+    for (size_t i = first; i < last; ++i) {
+        PriceBar bar;
+        bar.timestamp = toTimePoint(timestamps_[i]);
+        bar.Open = open_[i];
+        bar.High = high_[i];
+        bar.Low = low_[i];
+        bar.Close = close_[i];
+        bar.Volume = volume_[i];
+        out.push_back(bar);
+    }
+}
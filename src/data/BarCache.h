@@ -0,0 +1,118 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <csv2/mio.hpp>
+#include "data/PriceBar.h"
+#include "data/PageHints.h"
+
+/**
+ * @brief Versioned binary columnar cache of the bars parsed from one CSV file.
+ *
+ * After a symbol file has been parsed in full, DataManager writes its bars to
+ * `<cache dir>/<csv file name>.bars`: a fixed header followed by the timestamp,
+ * open, high, low, close and volume columns as contiguous 64-byte aligned
+ * arrays. Later loads map the cache file read-only and copy the columns out
+ * instead of parsing the text again.
+ *
+ * A cache file is only used if its header matches the current source file
+ * (size, modification time and a checksum over sampled blocks of its bytes)
+ * and the loader settings that affect the decoded values (the UTC offset of
+ * the timestamp columns). Anything else counts as a miss and the CSV is
+ * parsed again, which rewrites the cache.
+ *
+ * The file is written in native byte order; the header magic doubles as an
+ * endianness check.
+ */
+class BarCache {
+public:
+    static constexpr uint32_t FORMAT_VERSION = 1;
+
+    // Identifies the exact contents of a source CSV file.
+    struct SourceStamp {
+        uint64_t size = 0;
+        int64_t mtime = 0;     // filesystem clock ticks
+        uint64_t checksum = 0; // over sampled blocks of the file, see stampSource
+    };
+
+    // Diagnostics produced by the original parse, replayed on a cache hit.
+    struct Message {
+        bool is_error = false;
+        std::string text;
+    };
+
+    // Stamps the source file `path`, whose contents are already mapped at data[0, size).
+    static SourceStamp stampSource(const std::string& path, const char* data, size_t size);
+
+    // Cache file used for `sourcePath` inside `cacheDir`.
+    static std::string cachePathFor(const std::string& cacheDir, const std::string& sourcePath);
+
+    /**
+     * @brief Writes `bars` (sorted by timestamp) to `cachePath`.
+     *
+     * The data goes to a temporary file that is renamed into place, so
+     * concurrent readers never observe a partially written cache.
+     * @param sourceInOrder true if the CSV rows were already chronological,
+     *        i.e. the first N bars of the cache are also the first N valid rows.
+     * @return false with `error` set if the file could not be written.
+     */
+    static bool write(const std::string& cachePath, const SourceStamp& source, std::chrono::seconds utcOffset,
+                      const std::vector<PriceBar>& bars, bool sourceInOrder,
+                      const std::vector<Message>& messages, std::string& error);
+
+    /**
+     * @brief Maps `cachePath` and validates it against the current source.
+     * @return false if the cache is missing, stale, from another format
+     *         version or truncated; the object is then left closed.
+     */
+    bool open(const std::string& cachePath, const SourceStamp& source, std::chrono::seconds utcOffset);
+
+    bool isOpen() const { return mapped_.is_mapped(); }
+    // Applies the mapping hints of `hints` (see PageHints) to the open cache file.
+    void adviseMapping(const PageHints& hints) const { hints.adviseMapping(mapped_.data(), mapped_.size()); }
+    size_t rowCount() const { return rows_; }
+    bool sourceInOrder() const { return sourceInOrder_; }
+    std::chrono::system_clock::time_point minTime() const { return toTimePoint(minTime_); }
+    std::chrono::system_clock::time_point maxTime() const { return toTimePoint(maxTime_); }
+    const std::vector<Message>& messages() const { return messages_; }
+
+    // Column views into the mapping, valid while the cache is open.
+    const int64_t* timestamps() const { return timestamps_; } // system_clock ticks
+    const double* opens() const { return open_; }
+    const double* highs() const { return high_; }
+    const double* lows() const { return low_; }
+    const double* closes() const { return close_; }
+    const int64_t* volumes() const { return volume_; }
+
+    // Appends the first min(rowCount(), maxRows) bars to `out`.
+    void appendBars(std::vector<PriceBar>& out, size_t maxRows) const;
+    // Appends the bars with start <= timestamp < end, found by binary search
+    // over the (sorted) timestamp column.
+    void appendBarsInRange(std::vector<PriceBar>& out, std::chrono::system_clock::time_point start,
+                           std::chrono::system_clock::time_point end) const;
+
+private:
+    void appendRows(std::vector<PriceBar>& out, size_t first, size_t last) const;
+    size_t lowerBound(std::chrono::system_clock::time_point t) const;
+
+    static std::chrono::system_clock::time_point toTimePoint(int64_t ticks) {
+        return std::chrono::system_clock::time_point(std::chrono::system_clock::duration(ticks));
+    }
+
+    mio::mmap_source mapped_;
+    size_t rows_ = 0;
+    bool sourceInOrder_ = false;
+    int64_t minTime_ = 0;
+    int64_t maxTime_ = 0;
+    std::vector<Message> messages_;
+    const int64_t* timestamps_ = nullptr;
+    const double* open_ = nullptr;
+    const double* high_ = nullptr;
+    const double* low_ = nullptr;
+    const double* close_ = nullptr;
+    const int64_t* volume_ = nullptr;
+};
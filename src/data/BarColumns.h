@@ -0,0 +1,116 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+#include "data/PageHints.h"
+#include "data/PriceBar.h"
+
+/**
+ * @brief Non-owning view of a contiguous column (a minimal std::span for C++17).
+ */
+template <typename T>
+class ColumnSpan {
+public:
+    ColumnSpan() = default;
+    ColumnSpan(T* data, size_t size) : data_(data), size_(size) {}
+    template <typename U>
+    ColumnSpan(const std::vector<U>& values) : data_(values.data()), size_(values.size()) {}
+
+    T* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    T& operator[](size_t i) const { return data_[i]; }
+    T& front() const { return data_[0]; }
+    T& back() const { return data_[size_ - 1]; }
+    T* begin() const { return data_; }
+    T* end() const { return data_ + size_; }
+
+    // Elements [offset, offset + count), clamped to the end of the view.
+    ColumnSpan subspan(size_t offset, size_t count = static_cast<size_t>(-1)) const {
+        if (offset > size_) offset = size_;
+        if (count > size_ - offset) count = size_ - offset;
+        return ColumnSpan(data_ + offset, count);
+    }
+
+private:
+    T* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+/**
+ * @brief Struct-of-arrays storage for one symbol's bars.
+ *
+ * Each field of PriceBar lives in its own contiguous vector, so a scan over a
+ * single field (e.g. every Close) touches 8 bytes per bar instead of the whole
+ * 48-byte struct and can be vectorized by the compiler.
+ */
+struct BarColumns {
+    std::vector<std::chrono::system_clock::time_point> timestamp;
+    std::vector<double> open;
+    std::vector<double> high;
+    std::vector<double> low;
+    std::vector<double> close;
+    std::vector<long long> volume;
+
+    size_t size() const { return timestamp.size(); }
+    bool empty() const { return timestamp.empty(); }
+
+    void reserve(size_t n, const PageHints& hints = {}) {
+        hints.reserve(timestamp, n);
+        hints.reserve(open, n);
+        hints.reserve(high, n);
+        hints.reserve(low, n);
+        hints.reserve(close, n);
+        hints.reserve(volume, n);
+    }
+
+    void clear() {
+        timestamp.clear();
+        open.clear();
+        high.clear();
+        low.clear();
+        close.clear();
+        volume.clear();
+    }
+
+    void push_back(const PriceBar& bar) {
+        timestamp.push_back(bar.timestamp);
+        open.push_back(bar.Open);
+        high.push_back(bar.High);
+        low.push_back(bar.Low);
+        close.push_back(bar.Close);
+        volume.push_back(bar.Volume);
+    }
+
+    template <typename It>
+    void append(It first, It last) {
+        const size_t needed = size() + static_cast<size_t>(std::distance(first, last));
+        if (needed > timestamp.capacity()) {
+            reserve(std::max(needed, 2 * timestamp.capacity())); // Stay geometric across appends
+        }
+        for (; first != last; ++first) push_back(*first);
+    }
+
+    // Reassembles bar i as a PriceBar.
+    PriceBar bar(size_t i) const {
+        PriceBar b;
+        b.timestamp = timestamp[i];
+        b.Open = open[i];
+        b.High = high[i];
+        b.Low = low[i];
+        b.Close = close[i];
+        b.Volume = volume[i];
+        return b;
+    }
+
+    static BarColumns fromRows(const std::vector<PriceBar>& rows, const PageHints& hints = {}) {
+        BarColumns columns;
+        columns.reserve(rows.size(), hints);
+        columns.append(rows.begin(), rows.end());
+        return columns;
+    }
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "data/PriceBar.h"
+#include "data/MarketDataset.h"
+#include "data/Timeframe.h"
+
+/**
+ * @brief Folds one symbol's bars into bars of a higher timeframe, O(1) per bar.
+ *
+ * Only the bucket being filled is kept. A bucket is complete when the first
+ * bar of a later bucket arrives, which is also the earliest moment a replay
+ * could know it is complete, so emitting it then does not look ahead.
+ */
+class BarAggregator {
+public:
+    explicit BarAggregator(Timeframe timeframe = {}) : timeframe_(timeframe) {}
+
+    const Timeframe& timeframe() const { return timeframe_; }
+
+    // Adds the next bar (in timestamp order). Returns true and sets `completed`
+    // when `bar` starts a new bucket and so completes the previous one.
+    bool add(const PriceBar& bar, PriceBar& completed) {
+        const Timeframe::TimePoint start = timeframe_.bucketStart(bar.timestamp);
+        const bool done = open_ && start != current_.timestamp;
+        if (done) {
+            completed = current_;
+        }
+        if (!open_ || done) {
+            current_ = bar;
+            current_.timestamp = start;
+            open_ = true;
+        } else {
+            current_.High = std::max(current_.High, bar.High);
+            current_.Low = std::min(current_.Low, bar.Low);
+            current_.Close = bar.Close;
+            current_.Volume += bar.Volume;
+        }
+        return done;
+    }
+
+    // The bucket still being filled, or nullptr before the first bar.
+    const PriceBar* partial() const { return open_ ? &current_ : nullptr; }
+
+    // Completes the bucket being filled, e.g. at the end of the data.
+    bool flush(PriceBar& completed) {
+        if (!open_) return false;
+        completed = current_;
+        open_ = false;
+        return true;
+    }
+
+private:
+    Timeframe timeframe_;
+    PriceBar current_;
+    bool open_ = false;
+};
+
+/**
+ * @brief One symbol's bars resampled to a timeframe, extended incrementally.
+ *
+ * Remembers how many source bars it has consumed, so bringing it up to date
+ * after bars were appended (DataManager::refreshData) costs O(new bars).
+ */
+struct ResampledSeries {
+    std::vector<PriceBar> bars;  // Completed buckets, in order
+    BarAggregator aggregator;    // Holds the bucket still being filled
+    size_t consumed = 0;         // Source bars folded in so far
+
+    explicit ResampledSeries(Timeframe timeframe = {}) : aggregator(timeframe) {}
+
+    const Timeframe& timeframe() const { return aggregator.timeframe(); }
+    const PriceBar* partial() const { return aggregator.partial(); }
+
+    void update(const MarketDataset::SeriesView& series) {
+        PriceBar completed;
+        for (const size_t n = series.size(); consumed < n; ++consumed) {
+            if (aggregator.add(series.bar(consumed), completed)) {
+                bars.push_back(completed);
+            }
+        }
+    }
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "data/PriceBar.h"
+
+/**
+ * @brief One symbol's bars, pulled one at a time in timestamp order.
+ *
+ * The source of bars that are not held in memory up front (a file read
+ * incrementally, a network feed, a generator). MergeCursor combines any
+ * number of streams into synchronized snapshots.
+ */
+class BarStream {
+public:
+    virtual ~BarStream() = default;
+
+    virtual const std::string& symbol() const = 0;
+
+    // Stores the next bar in `bar`; false once the stream is exhausted.
+    // Timestamps must be non-decreasing.
+    virtual bool next(PriceBar& bar) = 0;
+};
+
+// Stream over bars already in memory.
+class VectorBarStream : public BarStream {
+public:
+    VectorBarStream(std::string symbol, std::vector<PriceBar> bars)
+        : symbol_(std::move(symbol)), bars_(std::move(bars)) {}
+
+    const std::string& symbol() const override { return symbol_; }
+
+    bool next(PriceBar& bar) override {
+        if (pos_ >= bars_.size()) return false;
+        bar = bars_[pos_++];
+        return true;
+    }
+
+private:
+    std::string symbol_;
+    std::vector<PriceBar> bars_;
+    size_t pos_ = 0;
+};
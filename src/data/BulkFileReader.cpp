@@ -0,0 +1,487 @@
+#include "BulkFileReader.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+#include <new>
+#include <system_error>
+
+#ifdef HAVE_IO_URING
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr size_t PAGE_BYTES = 4096;
+// A registered buffer may not exceed 1 GiB.
+constexpr size_t MAX_ARENA_BYTES = size_t(1) << 30;
+
+size_t roundUpToPage(size_t bytes) {
+    return (bytes + PAGE_BYTES - 1) / PAGE_BYTES * PAGE_BYTES;
+}
+
+std::string describeErrno(int error) {
+    return std::system_category().message(error);
+}
+
+} // namespace
+
+#ifdef HAVE_IO_URING
+
+// Just enough of io_uring for batched reads, driven by raw syscalls so there
+// is no liburing dependency. Used only by the reader's worker thread.
+struct BulkFileReader::Ring {
+    int fd = -1;
+    void* sqRing = MAP_FAILED;
+    void* cqRing = MAP_FAILED;
+    void* sqeMap = MAP_FAILED;
+    size_t sqRingBytes = 0;
+    size_t cqRingBytes = 0;
+    size_t sqeBytes = 0;
+
+    unsigned* sqHead = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned* sqArray = nullptr;
+    unsigned sqMask = 0;
+    unsigned sqEntries = 0;
+    io_uring_sqe* sqes = nullptr;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned cqMask = 0;
+    io_uring_cqe* cqes = nullptr;
+
+    unsigned tail = 0;   // Submission tail, published by submit()
+    unsigned queued = 0; // SQEs filled but not yet taken by the kernel
+
+    ~Ring() {
+        if (sqeMap != MAP_FAILED) munmap(sqeMap, sqeBytes);
+        if (cqRing != MAP_FAILED && cqRing != sqRing) munmap(cqRing, cqRingBytes);
+        if (sqRing != MAP_FAILED) munmap(sqRing, sqRingBytes);
+        if (fd >= 0) close(fd);
+    }
+
+    // Returns 0 or an errno value.
+    int open(unsigned depth) {
+        io_uring_params params{};
+        fd = static_cast<int>(syscall(__NR_io_uring_setup, depth, &params));
+        if (fd < 0) return errno;
+
+        sqRingBytes = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingBytes = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMap) sqRingBytes = cqRingBytes = std::max(sqRingBytes, cqRingBytes);
+        sqRing = mmap(nullptr, sqRingBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if (sqRing == MAP_FAILED) return errno;
+        cqRing = singleMap ? sqRing
+                           : mmap(nullptr, cqRingBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (cqRing == MAP_FAILED) return errno;
+        sqeBytes = params.sq_entries * sizeof(io_uring_sqe);
+        sqeMap = mmap(nullptr, sqeBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+        if (sqeMap == MAP_FAILED) return errno;
+
+        char* sq = static_cast<char*>(sqRing);
+        sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqEntries = params.sq_entries;
+        sqes = static_cast<io_uring_sqe*>(sqeMap);
+        char* cq = static_cast<char*>(cqRing);
+        cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        tail = *sqTail;
+        return 0;
+    }
+
+    // Registers [data, data + bytes) as fixed buffer 0. Returns 0 or an errno
+    // value (typically ENOMEM when it exceeds RLIMIT_MEMLOCK).
+    int registerBuffer(void* data, size_t bytes) {
+        iovec buffer{data, bytes};
+        return syscall(__NR_io_uring_register, fd, IORING_REGISTER_BUFFERS, &buffer, 1) < 0 ? errno : 0;
+    }
+
+    // A zeroed SQE to fill in, or nullptr if the submission ring is full.
+    io_uring_sqe* nextSqe() {
+        const unsigned head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+        if (tail - head >= sqEntries) return nullptr;
+        const unsigned slot = tail & sqMask;
+        io_uring_sqe* sqe = &sqes[slot];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqArray[slot] = slot;
+        ++tail;
+        ++queued;
+        return sqe;
+    }
+
+    // Submits the queued SQEs and, with waitFor > 0, waits until that many
+    // completions are ready. Returns 0 or an errno value.
+    int submit(unsigned waitFor) {
+        __atomic_store_n(sqTail, tail, __ATOMIC_RELEASE);
+        const unsigned flags = waitFor > 0 ? IORING_ENTER_GETEVENTS : 0;
+        while (true) {
+            const long taken = syscall(__NR_io_uring_enter, fd, queued, waitFor, flags, nullptr, 0);
+            if (taken >= 0) {
+                queued -= std::min<unsigned>(queued, static_cast<unsigned>(taken));
+                return 0;
+            }
+            if (errno == EINTR) continue;
+            // Completion queue backed up: wait for completions without submitting.
+            if ((errno == EAGAIN || errno == EBUSY) && waitFor > 0) {
+                if (syscall(__NR_io_uring_enter, fd, 0, waitFor, flags, nullptr, 0) >= 0) return 0;
+                if (errno == EINTR) continue;
+            }
+            return errno;
+        }
+    }
+
+    // Calls handle(cqe) for every completion that is ready.
+    template <typename Handle>
+    void reap(Handle&& handle) {
+        unsigned head = *cqHead;
+        const unsigned ready = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        for (; head != ready; ++head) {
+            handle(cqes[head & cqMask]);
+        }
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+    }
+};
+
+#else
+
+struct BulkFileReader::Ring {};
+
+#endif
+
+bool BulkFileReader::available() {
+#ifdef HAVE_IO_URING
+    static const bool usable = [] {
+        Ring probe;
+        return probe.open(2) == 0;
+    }();
+    return usable;
+#else
+    return false;
+#endif
+}
+
+BulkFileReader::BulkFileReader(std::vector<std::string> paths, size_t budgetBytes)
+    : paths_(std::move(paths)), files_(paths_.size()) {
+#ifdef HAVE_IO_URING
+    // The arena only needs to hold what there is to read.
+    size_t totalBytes = 0;
+    for (const auto& path : paths_) {
+        std::error_code ec;
+        const auto size = std::filesystem::file_size(path, ec);
+        if (!ec) totalBytes += roundUpToPage(static_cast<size_t>(size));
+    }
+    arena_bytes_ = std::min({roundUpToPage(budgetBytes), std::max(totalBytes, PAGE_BYTES), MAX_ARENA_BYTES});
+    arena_bytes_ = std::max(arena_bytes_, PAGE_BYTES);
+
+    ring_ = std::make_unique<Ring>();
+    if (const int error = ring_->open(QUEUE_DEPTH)) {
+        setup_error_ = "io_uring unavailable: " + describeErrno(error);
+        arena_bytes_ = 0;
+    } else {
+        void* arena = mmap(nullptr, arena_bytes_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (arena == MAP_FAILED) {
+            setup_error_ = "cannot allocate read buffers: " + describeErrno(errno);
+            arena_bytes_ = 0;
+        } else {
+            arena_ = static_cast<char*>(arena);
+            free_.emplace(0, arena_bytes_);
+            registered_ = ring_->registerBuffer(arena_, arena_bytes_) == 0;
+        }
+    }
+#else
+    setup_error_ = "no io_uring support in this build";
+#endif
+    worker_ = std::thread(&BulkFileReader::run, this);
+}
+
+BulkFileReader::~BulkFileReader() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    released_.notify_all();
+    worker_.join();
+#ifdef HAVE_IO_URING
+    if (arena_) munmap(arena_, arena_bytes_);
+#endif
+}
+
+bool BulkFileReader::next(File& file) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    ready_.wait(lock, [this] { return !completed_.empty() || handed_out_ == files_.size(); });
+    if (completed_.empty()) {
+        return false;
+    }
+    const size_t index = completed_.front();
+    completed_.pop_front();
+    ++handed_out_;
+    const Entry& entry = files_[index];
+    file.index = index;
+    file.error = entry.error;
+    file.data = entry.error.empty() ? entry.data : nullptr;
+    file.size = entry.error.empty() ? entry.size : 0;
+    return true;
+}
+
+void BulkFileReader::release(const File& file) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Entry& entry = files_[file.index];
+        if (entry.inArena) {
+            // Return the range to the free list, merged with free neighbours.
+            const size_t offset = static_cast<size_t>(entry.data - arena_);
+            auto range = free_.emplace(offset, roundUpToPage(entry.size)).first;
+            if (range != free_.begin()) {
+                auto before = std::prev(range);
+                if (before->first + before->second == range->first) {
+                    before->second += range->second;
+                    free_.erase(range);
+                    range = before;
+                }
+            }
+            auto after = std::next(range);
+            if (after != free_.end() && range->first + range->second == after->first) {
+                range->second += after->second;
+                free_.erase(after);
+            }
+            entry.inArena = false;
+        } else if (entry.own) {
+            entry.own.reset();
+            heap_in_use_ = false;
+        }
+        entry.data = nullptr;
+    }
+    released_.notify_all();
+}
+
+// Called with mutex_ held. First fit in the arena; a file larger than the
+// whole arena gets its own buffer, one such file at a time.
+bool BulkFileReader::allocate(Entry& entry) {
+    const size_t bytes = roundUpToPage(entry.size);
+    if (bytes <= arena_bytes_) {
+        for (auto range = free_.begin(); range != free_.end(); ++range) {
+            if (range->second < bytes) continue;
+            const size_t offset = range->first;
+            const size_t left = range->second - bytes;
+            free_.erase(range);
+            if (left > 0) free_.emplace(offset + bytes, left);
+            entry.data = arena_ + offset;
+            entry.inArena = true;
+            return true;
+        }
+        return false;
+    }
+    if (heap_in_use_) {
+        return false;
+    }
+    entry.own.reset(new (std::nothrow) char[entry.size]);
+    if (!entry.own) {
+        return false;
+    }
+    entry.data = entry.own.get();
+    heap_in_use_ = true;
+    return true;
+}
+
+// Called with mutex_ held.
+bool BulkFileReader::nothingAllocated() const {
+    const bool arenaFree = arena_bytes_ == 0 || (free_.size() == 1 && free_.begin()->second == arena_bytes_);
+    return arenaFree && !heap_in_use_;
+}
+
+void BulkFileReader::finish(size_t index) {
+    Entry& entry = files_[index];
+#ifdef HAVE_IO_URING
+    if (entry.fd >= 0) {
+        close(entry.fd);
+        entry.fd = -1;
+    }
+#endif
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        completed_.push_back(index);
+    }
+    ready_.notify_one();
+}
+
+void BulkFileReader::run() {
+    size_t nextFile = 0;
+    std::string failure = setup_error_;
+#ifdef HAVE_IO_URING
+    struct Read {
+        size_t file = 0;
+        size_t offset = 0;
+        size_t length = 0;
+        iovec buffer{};
+    };
+    std::vector<Read> reads(QUEUE_DEPTH); // Indexed by the SQE's user_data
+    std::vector<unsigned> idle;           // Unused entries of `reads`
+    for (unsigned slot = QUEUE_DEPTH; slot-- > 0;) idle.push_back(slot);
+    std::deque<Read> retries;             // Remainders of short or interrupted reads
+    std::vector<size_t> active;           // Files with a buffer and reads outstanding
+    unsigned inflight = 0;
+
+    auto queueRead = [&](const Read& read) {
+        if (idle.empty()) return false;
+        io_uring_sqe* sqe = ring_->nextSqe();
+        if (!sqe) return false;
+        const unsigned slot = idle.back();
+        idle.pop_back();
+        Read& queuedRead = reads[slot] = read;
+        Entry& entry = files_[read.file];
+        char* target = entry.data + read.offset;
+        if (registered_ && entry.inArena) {
+            sqe->opcode = IORING_OP_READ_FIXED;
+            sqe->addr = reinterpret_cast<uint64_t>(target);
+            sqe->len = static_cast<uint32_t>(read.length);
+            sqe->buf_index = 0;
+        } else {
+            queuedRead.buffer = {target, read.length};
+            sqe->opcode = IORING_OP_READV;
+            sqe->addr = reinterpret_cast<uint64_t>(&queuedRead.buffer);
+            sqe->len = 1;
+        }
+        sqe->fd = entry.fd;
+        sqe->off = read.offset;
+        sqe->user_data = slot;
+        ++entry.inflight;
+        ++inflight;
+        return true;
+    };
+
+    auto complete = [&](const io_uring_cqe& cqe) {
+        const unsigned slot = static_cast<unsigned>(cqe.user_data);
+        const Read read = reads[slot];
+        idle.push_back(slot);
+        --inflight;
+        Entry& entry = files_[read.file];
+        --entry.inflight;
+        if (cqe.res == -EINTR || cqe.res == -EAGAIN) {
+            retries.push_back(read);
+        } else if (cqe.res < 0) {
+            if (entry.error.empty()) entry.error = "read failed: " + describeErrno(-cqe.res);
+        } else if (cqe.res == 0) {
+            if (entry.error.empty()) entry.error = "file shrank while being read";
+        } else {
+            const size_t got = static_cast<size_t>(cqe.res);
+            entry.completed += got;
+            if (got < read.length) {
+                retries.push_back({read.file, read.offset + got, read.length - got, {}});
+            }
+        }
+    };
+
+    bool stopped = false;
+    while (failure.empty() && !stopped) {
+        // Start files, in order, while their buffers fit.
+        while (nextFile < files_.size() && active.size() < QUEUE_DEPTH) {
+            Entry& entry = files_[nextFile];
+            if (entry.fd < 0) {
+                entry.fd = open(paths_[nextFile].c_str(), O_RDONLY | O_CLOEXEC);
+                struct stat status;
+                if (entry.fd < 0 || fstat(entry.fd, &status) != 0) {
+                    entry.error = "cannot open: " + describeErrno(errno);
+                    finish(nextFile++);
+                    continue;
+                }
+                entry.size = static_cast<size_t>(status.st_size);
+                if (entry.size == 0) {
+                    finish(nextFile++);
+                    continue;
+                }
+            }
+            std::unique_lock<std::mutex> lock(mutex_);
+            bool allocated = allocate(entry);
+            if (!allocated) {
+                // With reads in flight, try again once some have completed;
+                // otherwise only a parser releasing a buffer can make room.
+                if (!active.empty() || stop_) break;
+                released_.wait(lock, [&] { return stop_ || (allocated = allocate(entry)) || nothingAllocated(); });
+                if (stop_) break;
+            }
+            lock.unlock();
+            if (!allocated) {
+                entry.error = "cannot allocate a read buffer";
+                finish(nextFile++);
+                continue;
+            }
+            active.push_back(nextFile++);
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopped = stop_;
+        }
+        if (stopped || active.empty()) break;
+
+        // Queue the remainders of short reads first, then new ranges in file order.
+        while (!retries.empty()) {
+            if (!files_[retries.front().file].error.empty()) {
+                retries.pop_front();
+            } else if (queueRead(retries.front())) {
+                retries.pop_front();
+            } else {
+                break;
+            }
+        }
+        for (size_t index : active) {
+            Entry& entry = files_[index];
+            while (entry.error.empty() && entry.submitted < entry.size) {
+                const size_t length = std::min(READ_BYTES, entry.size - entry.submitted);
+                if (!queueRead({index, entry.submitted, length, {}})) break;
+                entry.submitted += length;
+            }
+        }
+        if (const int error = ring_->submit(inflight > 0 ? 1 : 0)) {
+            failure = "io_uring_enter failed: " + describeErrno(error);
+            break;
+        }
+        ring_->reap(complete);
+
+        // Hand out the files whose reads have all completed.
+        active.erase(std::remove_if(active.begin(), active.end(), [&](size_t index) {
+            Entry& entry = files_[index];
+            if (entry.inflight > 0) return false;
+            if (entry.error.empty() && entry.completed < entry.size) return false;
+            finish(index);
+            return true;
+        }), active.end());
+    }
+
+    // The kernel may still write into the buffers until every read completes.
+    while (inflight > 0 && ring_->submit(1) == 0) {
+        ring_->reap(complete);
+    }
+    if (!stopped) {
+        for (size_t index : active) {
+            if (files_[index].error.empty()) files_[index].error = failure;
+            finish(index);
+        }
+    }
+    for (auto& entry : files_) {
+        if (entry.fd >= 0) {
+            close(entry.fd);
+            entry.fd = -1;
+        }
+    }
+    if (stopped) return;
+#endif
+    for (; nextFile < files_.size(); ++nextFile) {
+        files_[nextFile].error = failure;
+        finish(nextFile);
+    }
+}
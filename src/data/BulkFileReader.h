@@ -0,0 +1,99 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Reads whole files through one io_uring, many files in flight at once.
+ *
+ * A background thread opens the files in order, gives each a buffer carved out
+ * of one arena of at most budgetBytes and keeps up to QUEUE_DEPTH reads of
+ * READ_BYTES in flight across them, so a cold page cache is read at the
+ * device's queue depth instead of one page fault at a time as with mmap. The
+ * arena is registered with the ring (fixed-buffer reads) when the memlock
+ * limit allows; otherwise plain vectored reads go into the same arena.
+ *
+ * next() hands out completed files in completion order and may be called from
+ * several parser threads; release() returns a file's buffer. When the arena is
+ * full the thread waits for releases, so memory stays bounded by the budget,
+ * plus one file at a time that is larger than the whole arena and gets its own
+ * buffer.
+ *
+ * Built only where <linux/io_uring.h> exists (HAVE_IO_URING). available() also
+ * checks that the kernel permits io_uring, which containers often block;
+ * without it every file comes back with an error so callers fall back to mmap.
+ */
+class BulkFileReader {
+public:
+    static constexpr size_t READ_BYTES = size_t(1) << 20;
+    static constexpr unsigned QUEUE_DEPTH = 64;
+    static constexpr size_t DEFAULT_BUDGET_BYTES = size_t(256) << 20;
+
+    struct File {
+        size_t index = 0;            // Position in the constructor's `paths`
+        const char* data = nullptr;  // nullptr for an empty or unreadable file
+        size_t size = 0;
+        std::string error;           // Why the file could not be read; empty on success
+    };
+
+    // Whether this build has io_uring support and the kernel allows it.
+    static bool available();
+
+    explicit BulkFileReader(std::vector<std::string> paths, size_t budgetBytes = DEFAULT_BUDGET_BYTES);
+    ~BulkFileReader();
+    BulkFileReader(const BulkFileReader&) = delete;
+    BulkFileReader& operator=(const BulkFileReader&) = delete;
+
+    // Waits for the next completed file; false once every file was handed out.
+    bool next(File& file);
+    // Gives back the buffer of a file returned by next(); `file.data` is invalid afterwards.
+    void release(const File& file);
+
+    // Whether reads go into a buffer registered with the ring.
+    bool registeredBuffers() const { return registered_; }
+    size_t arenaBytes() const { return arena_bytes_; }
+
+private:
+    struct Ring;
+    struct Entry {
+        int fd = -1;
+        char* data = nullptr;
+        size_t size = 0;
+        size_t submitted = 0;  // Bytes for which a read was queued
+        size_t completed = 0;  // Bytes read
+        unsigned inflight = 0; // Reads queued and not yet completed
+        bool inArena = false;  // Otherwise `data` is owned by `own`
+        std::unique_ptr<char[]> own;
+        std::string error;
+    };
+
+    void run();
+    bool allocate(Entry& entry);
+    bool nothingAllocated() const;
+    void finish(size_t index);
+
+    std::vector<std::string> paths_;
+    std::vector<Entry> files_;
+    std::unique_ptr<Ring> ring_;
+    char* arena_ = nullptr;
+    size_t arena_bytes_ = 0;
+    bool registered_ = false;
+    std::string setup_error_; // Set if the ring could not be created
+
+    std::mutex mutex_;
+    std::condition_variable ready_;    // A file completed
+    std::condition_variable released_; // A buffer was released or the reader stops
+    std::map<size_t, size_t> free_;    // Free arena ranges, offset -> bytes
+    bool heap_in_use_ = false;         // An oversized file holds its own buffer
+    std::deque<size_t> completed_;     // Files waiting for next()
+    size_t handed_out_ = 0;
+    bool stop_ = false;
+    std::thread worker_;
+};
@@ -0,0 +1,199 @@
+#include "CompressedBars.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// Largest number of decimal digits tried for the scaled-integer price mode.
+constexpr int MAX_PRICE_DIGITS = 8;
+constexpr uint8_t XOR_PRICES = 0xFF;
+
+const double POW10[MAX_PRICE_DIGITS + 1] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8};
+
+uint64_t zigzag(int64_t v) { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+int64_t unzigzag(uint64_t v) { return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1); }
+
+void putVarint(std::vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+uint64_t getVarint(const uint8_t*& p) {
+    uint64_t v = 0;
+    for (unsigned shift = 0;; shift += 7) {
+        const uint8_t byte = *p++;
+        v |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (byte < 0x80) return v;
+    }
+}
+
+uint64_t bitsOf(double d) { uint64_t u; std::memcpy(&u, &d, sizeof(u)); return u; }
+double fromBits(uint64_t u) { double d; std::memcpy(&d, &u, sizeof(d)); return d; }
+
+// Fewest decimal digits that represent every price of the block exactly, or -1.
+// Compared bit for bit, so -0.0 (which decodes as +0.0) forces the XOR mode.
+int priceDigits(const PriceBar* bars, size_t count) {
+    for (int digits = 0; digits <= MAX_PRICE_DIGITS; ++digits) {
+        const double scale = POW10[digits];
+        bool exact = true;
+        for (size_t i = 0; exact && i < count; ++i) {
+            for (double price : {bars[i].Open, bars[i].High, bars[i].Low, bars[i].Close}) {
+                const double scaled = price * scale;
+                if (!(std::fabs(scaled) < 9.0e15) ||
+                    bitsOf(static_cast<double>(std::llround(scaled)) / scale) != bitsOf(price)) {
+                    exact = false;
+                    break;
+                }
+            }
+        }
+        if (exact) return digits;
+    }
+    return -1;
+}
+
+} // namespace
+
+size_t CompressedBars::blockOf(size_t i) const {
+    if (i >= sealed_bars_) return blocks_.size();
+    auto it = std::upper_bound(blocks_.begin(), blocks_.end(), i,
+                               [](size_t bar, const Block& b) { return bar < b.firstBar; });
+    return static_cast<size_t>(it - blocks_.begin()) - 1;
+}
+
+size_t CompressedBars::blockEnd(size_t block) const {
+    if (block + 1 < blocks_.size()) return blocks_[block + 1].firstBar;
+    return block < blocks_.size() ? sealed_bars_ : size();
+}
+
+void CompressedBars::clear() {
+    bytes_.clear();
+    blocks_.clear();
+    sealed_bars_ = 0;
+    tail_.clear();
+}
+
+void CompressedBars::push_back(const PriceBar& bar) {
+    if (tail_.empty()) tail_.reserve(BLOCK_BARS);
+    tail_.push_back(bar);
+    if (tail_.size() == BLOCK_BARS) sealTail();
+}
+
+void CompressedBars::shrink_to_fit(const PageHints& hints) {
+    if (!tail_.empty()) sealTail();
+    tail_.shrink_to_fit();
+    if (bytes_.capacity() != bytes_.size()) {
+        std::vector<uint8_t> bytes;
+        hints.reserve(bytes, bytes_.size());
+        bytes.assign(bytes_.begin(), bytes_.end());
+        bytes_.swap(bytes);
+    }
+    blocks_.shrink_to_fit();
+}
+
+void CompressedBars::sealTail() {
+    blocks_.push_back({bytes_.size(), sealed_bars_});
+    const PriceBar* bars = tail_.data();
+    const size_t count = tail_.size();
+
+    // Timestamps: first value, first delta, then delta-of-delta.
+    int64_t prevTime = 0;
+    int64_t prevDelta = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const int64_t t = bars[i].timestamp.time_since_epoch().count();
+        const int64_t delta = t - prevTime;
+        putVarint(bytes_, zigzag(i == 0 ? t : delta - prevDelta));
+        prevDelta = i == 0 ? 0 : delta;
+        prevTime = t;
+    }
+
+    const int digits = priceDigits(bars, count);
+    bytes_.push_back(digits < 0 ? XOR_PRICES : static_cast<uint8_t>(digits));
+    if (digits >= 0) {
+        const double scale = POW10[digits];
+        int64_t prevClose = 0;
+        for (size_t i = 0; i < count; ++i) {
+            const int64_t open = std::llround(bars[i].Open * scale);
+            const int64_t close = std::llround(bars[i].Close * scale);
+            putVarint(bytes_, zigzag(open - prevClose));
+            putVarint(bytes_, zigzag(close - open));
+            putVarint(bytes_, zigzag(std::llround(bars[i].High * scale) - std::max(open, close)));
+            putVarint(bytes_, zigzag(std::min(open, close) - std::llround(bars[i].Low * scale)));
+            prevClose = close;
+        }
+    } else {
+        uint64_t prev[4] = {0, 0, 0, 0};
+        for (size_t i = 0; i < count; ++i) {
+            const double fields[4] = {bars[i].Open, bars[i].High, bars[i].Low, bars[i].Close};
+            for (int f = 0; f < 4; ++f) {
+                const uint64_t bits = bitsOf(fields[f]);
+                putVarint(bytes_, bits ^ prev[f]);
+                prev[f] = bits;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        putVarint(bytes_, zigzag(bars[i].Volume));
+    }
+
+    sealed_bars_ += count;
+    tail_.clear();
+}
+
+void CompressedBars::decodeBlock(size_t block, std::vector<PriceBar>& out) const {
+    if (block >= blocks_.size()) {
+        out = tail_;
+        return;
+    }
+    const size_t count = blockEnd(block) - blockBegin(block);
+    out.resize(count);
+    const uint8_t* p = bytes_.data() + blocks_[block].offset;
+
+    int64_t time = 0;
+    int64_t delta = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const int64_t v = unzigzag(getVarint(p));
+        if (i == 0) {
+            time = v;
+        } else {
+            delta = (i == 1 ? 0 : delta) + v;
+            time += delta;
+        }
+        out[i].timestamp = std::chrono::system_clock::time_point(std::chrono::system_clock::duration(time));
+    }
+
+    const uint8_t mode = *p++;
+    if (mode != XOR_PRICES) {
+        const double scale = POW10[mode];
+        int64_t prevClose = 0;
+        for (size_t i = 0; i < count; ++i) {
+            const int64_t open = prevClose + unzigzag(getVarint(p));
+            const int64_t close = open + unzigzag(getVarint(p));
+            const int64_t high = std::max(open, close) + unzigzag(getVarint(p));
+            const int64_t low = std::min(open, close) - unzigzag(getVarint(p));
+            out[i].Open = static_cast<double>(open) / scale;
+            out[i].High = static_cast<double>(high) / scale;
+            out[i].Low = static_cast<double>(low) / scale;
+            out[i].Close = static_cast<double>(close) / scale;
+            prevClose = close;
+        }
+    } else {
+        uint64_t prev[4] = {0, 0, 0, 0};
+        for (size_t i = 0; i < count; ++i) {
+            double* fields[4] = {&out[i].Open, &out[i].High, &out[i].Low, &out[i].Close};
+            for (int f = 0; f < 4; ++f) {
+                prev[f] ^= getVarint(p);
+                *fields[f] = fromBits(prev[f]);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        out[i].Volume = unzigzag(getVarint(p));
+    }
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+#include "data/PageHints.h"
+#include "data/PriceBar.h"
+
+/**
+ * @brief Lossless compressed storage for one symbol's bars.
+ *
+ * Bars are packed in blocks of BLOCK_BARS:
+ *  - timestamps as zigzag varints of their delta-of-delta (regular 1s bars
+ *    cost one byte each),
+ *  - prices as scaled integers when every price of the block is an exact
+ *    decimal with at most 8 digits (Open relative to the previous Close,
+ *    Close relative to Open, the wicks relative to the body), otherwise as
+ *    varints of the XOR with the previous value of the same field,
+ *  - volumes as zigzag varints.
+ * Decoding reproduces every double bit for bit. The newest, not yet full
+ * block is kept as plain bars until it fills up or shrink_to_fit() seals it
+ * early, so a block may hold fewer than BLOCK_BARS bars.
+ *
+ * Access is block-wise: decodeBlock() unpacks one block, and Reader and the
+ * iterators keep the last decoded block, so walking the bars in order
+ * decodes each block once.
+ */
+class CompressedBars {
+public:
+    static constexpr size_t BLOCK_BARS = 256;
+
+    size_t size() const { return sealed_bars_ + tail_.size(); }
+    bool empty() const { return size() == 0; }
+    size_t blockCount() const { return blocks_.size() + (tail_.empty() ? 0 : 1); }
+    // Index of the first bar of `block`.
+    size_t blockBegin(size_t block) const { return block < blocks_.size() ? blocks_[block].firstBar : sealed_bars_; }
+    size_t blockEnd(size_t block) const;
+    // Block holding bar `i` (i < size()).
+    size_t blockOf(size_t i) const;
+
+    // Bytes held, including the uncompressed tail.
+    size_t memoryBytes() const {
+        return bytes_.capacity() + blocks_.capacity() * sizeof(Block) + tail_.capacity() * sizeof(PriceBar);
+    }
+
+    void clear();
+    void push_back(const PriceBar& bar);
+    template <typename It>
+    void append(It first, It last) {
+        for (; first != last; ++first) push_back(*first);
+    }
+    // Seals the partial tail block and releases spare capacity; call it once a
+    // batch of bars is complete. Appending afterwards starts a new block. The
+    // encoded bytes are moved to a buffer of their final size, which `hints`
+    // applies to (they grow while encoding, so only the final buffer qualifies).
+    void shrink_to_fit(const PageHints& hints = {});
+
+    // Replaces `out` with the bars of `block` (bars [blockBegin(block), blockEnd(block))).
+    void decodeBlock(size_t block, std::vector<PriceBar>& out) const;
+
+    static CompressedBars fromRows(const std::vector<PriceBar>& rows, const PageHints& hints = {}) {
+        CompressedBars bars;
+        bars.append(rows.begin(), rows.end());
+        bars.shrink_to_fit(hints);
+        return bars;
+    }
+
+    // Random access that decodes (and caches) the block holding the bar asked for.
+    class Reader {
+    public:
+        Reader() = default;
+        explicit Reader(const CompressedBars* bars) : bars_(bars) {}
+
+        explicit operator bool() const { return bars_ != nullptr; }
+        size_t size() const { return bars_ ? bars_->size() : 0; }
+
+        const PriceBar& operator[](size_t i) const {
+            if (i >= bars_->sealed_bars_) return bars_->tail_[i - bars_->sealed_bars_];
+            if (i < begin_ || i >= end_) {
+                const size_t block = bars_->blockOf(i);
+                bars_->decodeBlock(block, decoded_);
+                begin_ = bars_->blockBegin(block);
+                end_ = begin_ + decoded_.size();
+            }
+            return decoded_[i - begin_];
+        }
+
+    private:
+        const CompressedBars* bars_ = nullptr;
+        mutable size_t begin_ = 0; // Bars [begin_, end_) are in decoded_
+        mutable size_t end_ = 0;
+        mutable std::vector<PriceBar> decoded_;
+    };
+
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = PriceBar;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const PriceBar*;
+        using reference = const PriceBar&;
+
+        const_iterator(const CompressedBars* bars, size_t index) : reader_(bars), index_(index) {}
+
+        reference operator*() const { return reader_[index_]; }
+        pointer operator->() const { return &reader_[index_]; }
+        const_iterator& operator++() { ++index_; return *this; }
+        const_iterator operator++(int) { const_iterator old = *this; ++index_; return old; }
+        bool operator==(const const_iterator& other) const { return index_ == other.index_; }
+        bool operator!=(const const_iterator& other) const { return index_ != other.index_; }
+
+    private:
+        Reader reader_;
+        size_t index_;
+    };
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+private:
+    struct Block {
+        size_t offset;   // Start of the block in bytes_
+        size_t firstBar; // Index of its first bar
+    };
+    void sealTail();
+
+    std::vector<uint8_t> bytes_;
+    std::vector<Block> blocks_; // Sealed blocks
+    size_t sealed_bars_ = 0;
+    std::vector<PriceBar> tail_;        // Bars of the block being filled
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <charconv>   // For std::from_chars
+#include <cstddef>
+#include <cstdlib>    // For std::strtod (fallback path)
+#include <cstring>
+#include <string_view>
+#include <system_error>
+
+/**
+ * @brief Allocation-free conversions for CSV cell contents.
+ *
+ * All helpers take a std::string_view that points straight into the mapped
+ * file and report failure through their return value instead of throwing, so
+ * the per-row hot path never touches the heap or the exception machinery.
+ *
+ * Like std::stod/std::stoll (which the loader used before), a conversion
+ * succeeds as long as a numeric prefix could be read; trailing characters are
+ * ignored.
+ */
+namespace csvparse {
+
+inline bool parseDouble(std::string_view text, double& out) {
+    if (text.empty()) return false;
+    const char* first = text.data();
+    const char* last = first + text.size();
+    if (*first == '+') ++first; // from_chars rejects an explicit plus sign
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    auto res = std::from_chars(first, last, out);
+    return res.ec == std::errc() && res.ptr != first;
+#else
+    // Standard libraries without floating-point from_chars (older libc++):
+    // copy into a stack buffer so strtod sees a terminated string.
+    char buffer[64];
+    size_t len = static_cast<size_t>(last - first);
+    if (len >= sizeof(buffer)) return false;
+    std::memcpy(buffer, first, len);
+    buffer[len] = '\0';
+    char* end = nullptr;
+    out = std::strtod(buffer, &end);
+    return end != buffer;
+#endif
+}
+
+inline bool parseInt64(std::string_view text, long long& out) {
+    if (text.empty()) return false;
+    const char* first = text.data();
+    const char* last = first + text.size();
+    if (*first == '+') ++first;
+    auto res = std::from_chars(first, last, out);
+    return res.ec == std::errc() && res.ptr != first;
+}
+
+} // namespace csvparse
@@ -0,0 +1,275 @@
+#include "CsvInflater.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <memory>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+
+// Bytes inflated per decoder call; blocks grow in steps of this size.
+constexpr size_t INFLATE_STEP = size_t(64) << 10;
+
+bool endsWith(const std::string& text, const char* suffix) {
+    const size_t n = std::strlen(suffix);
+    if (text.size() < n) return false;
+    for (size_t i = 0; i < n; ++i) {
+        if (std::tolower(static_cast<unsigned char>(text[text.size() - n + i])) != suffix[i]) return false;
+    }
+    return true;
+}
+
+// Pulls inflated bytes out of one compressed buffer.
+class Decoder {
+public:
+    virtual ~Decoder() = default;
+    // Fills up to `capacity` bytes of `out`; 0 once the stream is complete.
+    // Sets `error` if the input is corrupt or truncated.
+    virtual size_t read(char* out, size_t capacity, std::string& error) = 0;
+};
+
+#ifdef HAVE_ZLIB
+class GzipDecoder : public Decoder {
+public:
+    GzipDecoder(const char* data, size_t size) : data_(data), size_(size) {
+        // 15 + 32: maximum window, gzip or zlib header detected automatically.
+        ok_ = inflateInit2(&stream_, 15 + 32) == Z_OK;
+    }
+    ~GzipDecoder() override { if (ok_) inflateEnd(&stream_); }
+
+    size_t read(char* out, size_t capacity, std::string& error) override {
+        if (!ok_) {
+            error = "could not initialise zlib";
+            return 0;
+        }
+        stream_.next_out = reinterpret_cast<Bytef*>(out);
+        stream_.avail_out = static_cast<uInt>(capacity);
+        while (stream_.avail_out > 0 && !finished_) {
+            if (stream_.avail_in == 0) {
+                if (consumed_ == size_) {
+                    error = "truncated gzip stream";
+                    break;
+                }
+                // avail_in is 32-bit; feed large files in slices.
+                const size_t slice = std::min<size_t>(size_ - consumed_, size_t(1) << 30);
+                stream_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data_ + consumed_));
+                stream_.avail_in = static_cast<uInt>(slice);
+                consumed_ += slice;
+            }
+            const int status = inflate(&stream_, Z_NO_FLUSH);
+            if (status == Z_STREAM_END) {
+                // Concatenated members (e.g. from appending with gzip >>) continue the stream.
+                if (stream_.avail_in == 0 && consumed_ == size_) {
+                    finished_ = true;
+                } else {
+                    inflateReset(&stream_);
+                }
+            } else if (status != Z_OK) {
+                error = stream_.msg ? stream_.msg : "corrupt gzip stream";
+                break;
+            }
+        }
+        return capacity - stream_.avail_out;
+    }
+
+private:
+    z_stream stream_{};
+    const char* data_;
+    size_t size_;
+    size_t consumed_ = 0;
+    bool ok_ = false;
+    bool finished_ = false;
+};
+#endif
+
+#ifdef HAVE_ZSTD
+class ZstdDecoder : public Decoder {
+public:
+    ZstdDecoder(const char* data, size_t size) : stream_(ZSTD_createDStream()), input_{data, size, 0} {
+        if (stream_) ZSTD_initDStream(stream_);
+    }
+    ~ZstdDecoder() override { ZSTD_freeDStream(stream_); }
+
+    size_t read(char* out, size_t capacity, std::string& error) override {
+        if (!stream_) {
+            error = "could not create zstd stream";
+            return 0;
+        }
+        ZSTD_outBuffer output{out, capacity, 0};
+        while (output.pos < output.size && !finished_) {
+            const size_t hint = ZSTD_decompressStream(stream_, &output, &input_);
+            if (ZSTD_isError(hint)) {
+                error = ZSTD_getErrorName(hint);
+                break;
+            }
+            if (input_.pos == input_.size && output.pos < output.size) {
+                // All input consumed and the output not full: the last frame must be complete.
+                if (hint != 0) error = "truncated zstd stream";
+                finished_ = true;
+            }
+        }
+        return output.pos;
+    }
+
+private:
+    ZSTD_DStream* stream_;
+    ZSTD_inBuffer input_;
+    bool finished_ = false;
+};
+#endif
+
+std::unique_ptr<Decoder> makeDecoder(CsvInflater::Codec codec, const char* data, size_t size) {
+    switch (codec) {
+#ifdef HAVE_ZLIB
+        case CsvInflater::Codec::Gzip: return std::make_unique<GzipDecoder>(data, size);
+#endif
+#ifdef HAVE_ZSTD
+        case CsvInflater::Codec::Zstd: return std::make_unique<ZstdDecoder>(data, size);
+#endif
+        default: return nullptr;
+    }
+}
+
+} // namespace
+
+CsvInflater::Codec CsvInflater::codecOf(const std::string& path) {
+    if (endsWith(path, ".gz")) return Codec::Gzip;
+    if (endsWith(path, ".zst")) return Codec::Zstd;
+    return Codec::None;
+}
+
+bool CsvInflater::available(Codec codec) {
+    switch (codec) {
+        case Codec::None: return true;
+#ifdef HAVE_ZLIB
+        case Codec::Gzip: return true;
+#endif
+#ifdef HAVE_ZSTD
+        case Codec::Zstd: return true;
+#endif
+        default: return false;
+    }
+}
+
+const char* CsvInflater::name(Codec codec) {
+    switch (codec) {
+        case Codec::Gzip: return "gzip";
+        case Codec::Zstd: return "zstd";
+        default: return "none";
+    }
+}
+
+std::string CsvInflater::stripCodecExtension(const std::string& path) {
+    switch (codecOf(path)) {
+        case Codec::Gzip: return path.substr(0, path.size() - 3);
+        case Codec::Zstd: return path.substr(0, path.size() - 4);
+        default: return path;
+    }
+}
+
+CsvInflater::CsvInflater(const char* data, size_t size, Codec codec, size_t blockBytes)
+    : data_(data), size_(size), codec_(codec), block_bytes_(std::max<size_t>(blockBytes, INFLATE_STEP)) {
+    worker_ = std::thread(&CsvInflater::run, this);
+}
+
+CsvInflater::~CsvInflater() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    drained_.notify_all();
+    worker_.join();
+}
+
+bool CsvInflater::next(std::vector<char>& block) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    ready_.wait(lock, [this] { return !queue_.empty() || done_; });
+    if (queue_.empty()) {
+        return false;
+    }
+    if (block.capacity() > 0) {
+        free_.push_back(std::move(block));
+    }
+    block = std::move(queue_.front());
+    queue_.pop_front();
+    lock.unlock();
+    drained_.notify_one();
+    return true;
+}
+
+bool CsvInflater::push(std::vector<char>&& block) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    drained_.wait(lock, [this] { return queue_.size() < QUEUE_BLOCKS || stop_; });
+    if (stop_) {
+        return false;
+    }
+    queue_.push_back(std::move(block));
+    lock.unlock();
+    ready_.notify_one();
+    return true;
+}
+
+std::vector<char> CsvInflater::takeFree() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (free_.empty()) {
+        std::vector<char> block;
+        block.reserve(block_bytes_ + INFLATE_STEP);
+        return block;
+    }
+    std::vector<char> block = std::move(free_.back());
+    free_.pop_back();
+    block.clear();
+    return block;
+}
+
+void CsvInflater::run() {
+    std::string error;
+    std::unique_ptr<Decoder> decoder = makeDecoder(codec_, data_, size_);
+    if (!decoder) {
+        error = std::string("no ") + name(codec_) + " support in this build";
+    }
+
+    std::vector<char> block = takeFree();
+    bool open = decoder != nullptr;
+    while (open) {
+        const size_t used = block.size();
+        block.resize(used + INFLATE_STEP);
+        const size_t got = decoder->read(block.data() + used, INFLATE_STEP, error);
+        block.resize(used + got);
+        open = got > 0 && error.empty();
+        if (!open || block.size() < block_bytes_) {
+            continue;
+        }
+        // Cut after the last complete row; the rest starts the next block. A
+        // block without any newline (one enormous row) just keeps growing.
+        auto newline = std::find(block.rbegin(), block.rend(), '\n');
+        if (newline == block.rend()) {
+            continue;
+        }
+        const size_t cut = static_cast<size_t>(block.rend() - newline);
+        std::vector<char> rest = takeFree();
+        rest.insert(rest.end(), block.begin() + cut, block.end());
+        block.resize(cut);
+        if (!push(std::move(block))) {
+            return;
+        }
+        block = std::move(rest);
+    }
+    if (error.empty() && !block.empty() && !push(std::move(block))) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        error_ = error;
+        done_ = true;
+    }
+    ready_.notify_all();
+}
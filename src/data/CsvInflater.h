@@ -0,0 +1,71 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Streams a gzip or zstd compressed CSV as newline-aligned blocks.
+ *
+ * A background thread inflates the compressed bytes (usually an mmap'd .csv.gz
+ * or .csv.zst file) into blocks of about BLOCK_BYTES while the caller parses
+ * the previous one, so inflating and parsing overlap and the plain CSV never
+ * touches the disk. At most QUEUE_BLOCKS blocks wait to be parsed; the thread
+ * blocks until the caller catches up, so memory stays bounded by the block size.
+ *
+ * Every block except the last ends with '\n': a row that straddles a block
+ * boundary is carried over whole to the next block, so each block can be
+ * handed to the row scanner on its own.
+ */
+class CsvInflater {
+public:
+    enum class Codec { None, Gzip, Zstd };
+
+    static constexpr size_t BLOCK_BYTES = size_t(1) << 20;
+    static constexpr size_t QUEUE_BLOCKS = 2;
+
+    // Codec by file extension: ".gz" is gzip, ".zst" is zstd (case-insensitive).
+    static Codec codecOf(const std::string& path);
+    // Whether this build can inflate `codec` (zlib and zstd are optional at build time).
+    static bool available(Codec codec);
+    static const char* name(Codec codec);
+    // `path` without its compression extension ("a/x.csv.gz" -> "a/x.csv").
+    static std::string stripCodecExtension(const std::string& path);
+
+    // `data` must outlive the inflater.
+    CsvInflater(const char* data, size_t size, Codec codec, size_t blockBytes = BLOCK_BYTES);
+    ~CsvInflater();
+    CsvInflater(const CsvInflater&) = delete;
+    CsvInflater& operator=(const CsvInflater&) = delete;
+
+    // Replaces `block` with the next block, handing the old buffer back for
+    // reuse; false at the end of the stream or if inflating failed (error()).
+    bool next(std::vector<char>& block);
+    // Why the stream ended early; empty after a complete stream.
+    const std::string& error() const { return error_; }
+
+private:
+    void run();
+    bool push(std::vector<char>&& block);
+    std::vector<char> takeFree();
+
+    const char* data_;
+    size_t size_;
+    Codec codec_;
+    size_t block_bytes_;
+
+    std::mutex mutex_;
+    std::condition_variable ready_;   // A block was queued or the stream ended
+    std::condition_variable drained_; // A queued block was taken or the inflater stops
+    std::deque<std::vector<char>> queue_;
+    std::vector<std::vector<char>> free_; // Buffers handed back by next()
+    bool done_ = false;
+    bool stop_ = false;
+    std::string error_;
+    std::thread worker_;
+};
@@ -0,0 +1,255 @@
+#include "CsvScanner.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CSVSCAN_X86 1
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define CSVSCAN_AVX2 1
+#include <immintrin.h>
+#endif
+#endif
+
+namespace csvparse {
+
+namespace {
+
+// Raw per-byte classification of whole 64-byte words; quotes are resolved afterwards.
+using ClassifyFn = void (*)(const char* data, size_t words, char delimiter,
+                            uint64_t* delimiters, uint64_t* newlines, uint64_t* quotes);
+
+void classifyScalar(const char* data, size_t words, char delimiter,
+                    uint64_t* delimiters, uint64_t* newlines, uint64_t* quotes) {
+    for (size_t w = 0; w < words; ++w) {
+        const char* p = data + w * 64;
+        uint64_t d = 0, n = 0, q = 0;
+        for (unsigned i = 0; i < 64; ++i) {
+            const uint64_t bit = uint64_t(1) << i;
+            d |= (p[i] == delimiter) ? bit : 0;
+            n |= (p[i] == '\n') ? bit : 0;
+            q |= (p[i] == '"') ? bit : 0;
+        }
+        delimiters[w] = d;
+        newlines[w] = n;
+        quotes[w] = q;
+    }
+}
+
+#if CSVSCAN_X86
+void classifySse2(const char* data, size_t words, char delimiter,
+                  uint64_t* delimiters, uint64_t* newlines, uint64_t* quotes) {
+    const __m128i vd = _mm_set1_epi8(delimiter);
+    const __m128i vn = _mm_set1_epi8('\n');
+    const __m128i vq = _mm_set1_epi8('"');
+    for (size_t w = 0; w < words; ++w) {
+        const char* p = data + w * 64;
+        uint64_t d = 0, n = 0, q = 0;
+        for (unsigned lane = 0; lane < 4; ++lane) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + lane * 16));
+            const unsigned shift = lane * 16;
+            d |= uint64_t(uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v, vd)))) << shift;
+            n |= uint64_t(uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v, vn)))) << shift;
+            q |= uint64_t(uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v, vq)))) << shift;
+        }
+        delimiters[w] = d;
+        newlines[w] = n;
+        quotes[w] = q;
+    }
+}
+#endif
+
+#if CSVSCAN_AVX2
+__attribute__((target("avx2")))
+void classifyAvx2(const char* data, size_t words, char delimiter,
+                  uint64_t* delimiters, uint64_t* newlines, uint64_t* quotes) {
+    const __m256i vd = _mm256_set1_epi8(delimiter);
+    const __m256i vn = _mm256_set1_epi8('\n');
+    const __m256i vq = _mm256_set1_epi8('"');
+    for (size_t w = 0; w < words; ++w) {
+        const char* p = data + w * 64;
+        __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+        delimiters[w] = uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, vd))))
+                      | uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, vd)))) << 32;
+        newlines[w]   = uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, vn))))
+                      | uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, vn)))) << 32;
+        quotes[w]     = uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, vq))))
+                      | uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, vq)))) << 32;
+    }
+}
+#endif
+
+struct Classifier {
+    ClassifyFn fn;
+    const char* name;
+};
+
+Classifier selectClassifier() {
+#if CSVSCAN_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return {classifyAvx2, "avx2"};
+#endif
+#if CSVSCAN_X86
+    return {classifySse2, "sse2"};
+#else
+    return {classifyScalar, "scalar"};
+#endif
+}
+
+Classifier& classifier() {
+    static Classifier selected = selectClassifier();
+    return selected;
+}
+
+// Bit i of the result is the XOR of bits 0..i of x: set for bytes after an odd
+// number of quotes, i.e. inside a quoted section.
+inline uint64_t prefixXor(uint64_t x) {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+inline unsigned countTrailingZeros(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctzll(x));
+#else
+    unsigned n = 0;
+    while ((x & 1) == 0) { x >>= 1; ++n; }
+    return n;
+#endif
+}
+
+inline bool isTrimChar(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+} // namespace
+
+void indexStructurals(const char* data, size_t len, char delimiter, StructuralBlock& out, bool& inQuotes) {
+    uint64_t quotes[StructuralBlock::WORDS];
+    const size_t fullWords = len / 64;
+    const size_t tail = len % 64;
+
+    classifier().fn(data, fullWords, delimiter, out.delimiters, out.newlines, quotes);
+    size_t words = fullWords;
+    if (tail != 0) {
+        // Pad the final partial word with a byte that is never structural.
+        char padded[64];
+        std::memset(padded, ' ', sizeof(padded));
+        std::memcpy(padded, data + fullWords * 64, tail);
+        classifyScalar(padded, 1, delimiter, out.delimiters + fullWords, out.newlines + fullWords, quotes + fullWords);
+        ++words;
+    }
+
+    for (size_t w = 0; w < words; ++w) {
+        if (quotes[w] == 0 && !inQuotes) continue; // Common case: unquoted numeric data
+        uint64_t quoted = prefixXor(quotes[w]) ^ (inQuotes ? ~uint64_t(0) : 0);
+        inQuotes = (quoted >> 63) != 0;
+        out.delimiters[w] &= ~quoted;
+        out.newlines[w] &= ~quoted;
+    }
+}
+
+const char* structuralIndexerName() {
+    return classifier().name;
+}
+
+bool selectStructuralIndexer(std::string_view name) {
+    if (name == "scalar") {
+        classifier() = {classifyScalar, "scalar"};
+        return true;
+    }
+#if CSVSCAN_X86
+    if (name == "sse2") {
+        classifier() = {classifySse2, "sse2"};
+        return true;
+    }
+#endif
+#if CSVSCAN_AVX2
+    __builtin_cpu_init();
+    if (name == "avx2" && __builtin_cpu_supports("avx2")) {
+        classifier() = {classifyAvx2, "avx2"};
+        return true;
+    }
+#endif
+    return false;
+}
+
+RowScanner::RowScanner(const char* data, size_t begin, size_t end, char delimiter)
+    : data_(data), pos_(begin), end_(end), delimiter_(delimiter),
+      block_(std::make_unique<StructuralBlock>()) {
+    loadBlock(begin);
+}
+
+void RowScanner::loadBlock(size_t blockStart) {
+    blockStart_ = blockStart;
+    size_t len = blockStart < end_ ? std::min(StructuralBlock::BYTES, end_ - blockStart) : 0;
+    blockWords_ = (len + 63) / 64;
+    word_ = 0;
+    if (len > 0) {
+        indexStructurals(data_ + blockStart, len, delimiter_, *block_, inQuotes_);
+        pending_ = block_->delimiters[0] | block_->newlines[0];
+    } else {
+        pending_ = 0;
+    }
+}
+
+bool RowScanner::nextStructural(size_t& offset, bool& isNewline) {
+    while (pending_ == 0) {
+        if (++word_ >= blockWords_) {
+            size_t nextBlock = blockStart_ + blockWords_ * 64;
+            if (nextBlock >= end_) {
+                word_ = blockWords_;
+                return false;
+            }
+            loadBlock(nextBlock);
+            if (pending_ != 0) break;
+            continue;
+        }
+        pending_ = block_->delimiters[word_] | block_->newlines[word_];
+    }
+    unsigned bit = countTrailingZeros(pending_);
+    pending_ &= pending_ - 1;
+    offset = blockStart_ + word_ * 64 + bit;
+    isNewline = ((block_->newlines[word_] >> bit) & 1) != 0;
+    return true;
+}
+
+std::string_view RowScanner::trimmedField(size_t first, size_t last) const {
+    while (first < last && isTrimChar(data_[first])) ++first;
+    while (last > first && isTrimChar(data_[last - 1])) --last;
+    return std::string_view(data_ + first, last - first);
+}
+
+bool RowScanner::nextRow(std::string_view* fields, size_t maxFields, size_t& fieldCount) {
+    if (pos_ >= end_) return false;
+
+    const size_t rowStart = pos_;
+    size_t fieldStart = pos_;
+    fieldCount = 0;
+    while (true) {
+        size_t offset = end_;
+        bool isNewline = true;
+        if (!nextStructural(offset, isNewline)) {
+            offset = end_; // Last row without a trailing newline
+            isNewline = true;
+        }
+        if (isNewline && offset == rowStart) {
+            pos_ = std::min(offset + 1, end_); // Empty line: no cells
+            return true;
+        }
+        if (fieldCount < maxFields) fields[fieldCount] = trimmedField(fieldStart, offset);
+        ++fieldCount;
+        if (isNewline) {
+            pos_ = std::min(offset + 1, end_);
+            return true;
+        }
+        fieldStart = offset + 1;
+    }
+}
+
+} // namespace csvparse
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+/**
+ * @brief Two-stage CSV row scanner over an in-memory (usually mmap'd) buffer.
+ *
+ * Stage 1 (indexStructurals) classifies a large block of input at a time into
+ * bitmaps of delimiter and newline positions, 64 bytes per word, using AVX2 or
+ * SSE2 where available and a portable scalar loop otherwise. Delimiters and
+ * newlines inside double-quoted sections are masked out with a prefix-XOR over
+ * the quote bitmap, so quoted cells may contain commas or line breaks.
+ *
+ * Stage 2 (RowScanner) walks the set bits with count-trailing-zeros and hands
+ * out each row's cells as string_views into the original buffer, trimmed of
+ * spaces, tabs and carriage returns. Nothing is copied or allocated per row.
+ */
+namespace csvparse {
+
+struct StructuralBlock {
+    static constexpr size_t WORDS = 1024;        // 64 KiB of input per block
+    static constexpr size_t BYTES = WORDS * 64;
+    uint64_t delimiters[WORDS];
+    uint64_t newlines[WORDS];
+};
+
+// Fills `out` with the structural bitmaps for data[0, len) (len <= BYTES).
+// `inQuotes` carries the open-quote state from one block to the next.
+void indexStructurals(const char* data, size_t len, char delimiter, StructuralBlock& out, bool& inQuotes);
+
+// Name of the stage-1 implementation selected for this CPU ("avx2", "sse2" or "scalar").
+const char* structuralIndexerName();
+
+// Switches stage 1 to the named implementation, e.g. to compare them in tests.
+// False (and nothing changes) if this build or CPU lacks it. Not safe while
+// other threads are scanning.
+bool selectStructuralIndexer(std::string_view name);
+
+class RowScanner {
+public:
+    // Scans rows in data[begin, end). `begin` must be the start of a row.
+    RowScanner(const char* data, size_t begin, size_t end, char delimiter = ',');
+
+    // Reads the next row. Up to N cells are stored in `fields`; `fieldCount`
+    // receives the total number of cells in the row (0 for an empty line).
+    // Returns false once the end of the range has been reached.
+    template <size_t N>
+    bool nextRow(std::string_view (&fields)[N], size_t& fieldCount) {
+        return nextRow(fields, N, fieldCount);
+    }
+    bool nextRow(std::string_view* fields, size_t maxFields, size_t& fieldCount);
+
+    // Byte offset where the next row starts.
+    size_t position() const { return pos_; }
+
+private:
+    bool nextStructural(size_t& offset, bool& isNewline);
+    void loadBlock(size_t blockStart);
+    std::string_view trimmedField(size_t first, size_t last) const;
+
+    const char* data_;
+    size_t pos_;
+    size_t end_;
+    char delimiter_;
+
+    std::unique_ptr<StructuralBlock> block_;
+    size_t blockStart_ = 0;
+    size_t blockWords_ = 0;
+    size_t word_ = 0;
+    uint64_t pending_ = 0; // structural bits of block_ word `word_` not yet consumed
+    bool inQuotes_ = false;
+};
+
+} // namespace csvparse
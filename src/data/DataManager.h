@@ -7,6 +7,7 @@
 #include <optional>
 #include <filesystem>
 #include <functional>
+#include <string_view>
 #include <memory> // Include for EventPtr potentially later? Or just use Event.h?
 #include <limits>
 #include <map>
@@ -15,102 +16,381 @@
 #include <ctime>
 
 #include "data/PriceBar.h" // Correct path
+#include "data/BarColumns.h"
+#include "data/MarketDataset.h"
+#include "data/ReplayCursor.h"
+#include "data/MergeCursor.h"
+#include "data/TimeIndex.h"
+#include "data/CsvInflater.h"
+#include "data/BarResampler.h"
+#include "data/CsvFieldParser.h"
+#include "data/TimestampParser.h"
+#include "data/PageHints.h"
 #include "core/Event.h"    // Include for DataSnapshot definition and Event types
 
 // Removed the duplicate 'using DataSnapshot = ...;' line
 
 class DataManager {
 public:
+    using TimePoint = std::chrono::system_clock::time_point;
+
     DataManager() : max_rows_to_load_(std::numeric_limits<size_t>::max()), 
-                   streaming_mode_(false), warmup_buffer_size_(200) {}
+                   streaming_mode_(false), warmup_buffer_size_(200), loader_threads_(0) {}
+    // Layout of the loaded bars. Rows keeps a vector<PriceBar> per symbol (getAssetData);
+    // Columns keeps a BarColumns per symbol (getAssetColumns and the span accessors) so
+    // single-field scans stream one array; RowsAndColumns keeps both. Compressed keeps a
+    // CompressedBars per symbol (getCompressedBars), several times smaller than Rows and
+    // decoded block by block during replay. Ticks keeps a TickColumns per symbol
+    // (getTickColumns): int64 prices in ticks of the symbol's tick size, converted
+    // back to doubles for replay. Applies to the next load.
+    enum class BarStorage { Rows, Columns, RowsAndColumns, Compressed, Ticks };
+    enum class PriceField { Open, High, Low, Close };
+
+    void setBarStorage(BarStorage storage) { bar_storage_ = storage; }
+    BarStorage getBarStorage() const { return bar_storage_; }
+    // Tick size of `symbol` in the Ticks storage mode. Symbols without one get
+    // the coarsest decimal tick that represents all of their loaded prices, or
+    // 1e-8 with a warning (prices off that grid are rounded) if none does.
+    void setTickSize(const std::string& symbol, double tickSize) { tick_sizes_[symbol] = TickSize(tickSize); }
+
     bool loadData(const std::string& dataPath);
+    // Loads only the bars with start <= timestamp < end (the row cap does not
+    // apply). Files served from the bar cache, or indexed by an earlier full
+    // load of this DataManager, are read from the window onwards instead of
+    // being parsed from the first row; others are parsed once in full, which
+    // builds their index for the next windowed load.
+    bool loadData(const std::string& dataPath, TimePoint start, TimePoint end);
+    // Loads only the files of `symbols` (empty = every file), e.g. the
+    // Strategy::required_symbols() of the next run, so the replay merges just
+    // those series. Each file parsed this way is kept per symbol, and later
+    // symbol loads reuse it instead of parsing it again while the file is
+    // unchanged and the row cap and UTC offset are the same. A reused file in
+    // the same bar storage shares its bars with the earlier load instead of
+    // copying them.
+    bool loadData(const std::string& dataPath, const std::vector<std::string>& symbols);
+    // Tail-follow for files that are appended to while loaded. Checks the size
+    // and mtime of every file of the last load and parses only the rows added
+    // since it was read, appending them to the symbol's series and to the
+    // replay timeline; the replay position is kept. Rows older than the
+    // symbol's last bar are skipped with a warning. Cost is O(new rows) while
+    // the new rows are later than every loaded tick and no ReplayCursor (e.g. a
+    // Backtester) or symbol load still holds the series appended to, which
+    // is copied otherwise. Files that shrank or were rewritten need a new
+    // loadData. Compressed files and loads with a row cap or a time window
+    // end are not followed. A row without a newline yet is read only once the
+    // newline is written, by the load as by this. Returns the number of bars
+    // appended.
+    size_t refreshData();
+    // Replaces the loaded data with `source`'s bars aggregated to `timeframe`
+    // (getResampledBars, plus the bucket still open at the end of the data):
+    // a coarser pyramid level of the same dataset, e.g. for screening
+    // parameter sets before running them at native resolution. Uses this
+    // DataManager's bar storage.
+    bool loadResampled(DataManager& source, const Timeframe& timeframe);
+    // Empty (nullopt) unless the bars are stored as Rows.
     std::optional<std::reference_wrapper<const std::vector<PriceBar>>> getAssetData(const std::string& symbol) const;
+    // Empty (nullopt) unless the bars are stored Compressed; iterate it to decode the bars in order.
+    std::optional<std::reference_wrapper<const CompressedBars>> getCompressedBars(const std::string& symbol) const;
+    // Empty (nullopt) unless the bars are stored as Ticks; the tick size is in TickColumns::tick.
+    std::optional<std::reference_wrapper<const TickColumns>> getTickColumns(const std::string& symbol) const;
+    // Empty (nullopt / empty spans) when the bars are stored as Rows only.
+    std::optional<std::reference_wrapper<const BarColumns>> getAssetColumns(const std::string& symbol) const;
+    // `symbol`'s bars aggregated to `timeframe`. Built on first use and cached
+    // per (symbol, timeframe) until the next load; bars appended since (e.g.
+    // by refreshData) are folded in on the next call at O(1) each. Empty
+    // (nullopt) if the symbol is not loaded.
+    std::optional<std::reference_wrapper<const ResampledSeries>> getResampledBars(const std::string& symbol,
+                                                                                  const Timeframe& timeframe);
+    ColumnSpan<const double> getPriceSpan(const std::string& symbol, PriceField field) const;
+    ColumnSpan<const long long> getVolumeSpan(const std::string& symbol) const;
+    ColumnSpan<const std::chrono::system_clock::time_point> getTimestampSpan(const std::string& symbol) const;
     std::vector<std::string> getAllSymbols() const;
 
+    // Dense SymbolIds for the loaded symbols, issued in name order at load time.
+    // Snapshots and events are keyed by these IDs; a reload creates a new table,
+    // so holders of the old shared_ptr keep a consistent view.
+    std::shared_ptr<const SymbolTable> getSymbolTable() const { return dataset_->symbolTable; }
+    SymbolId getSymbolId(const std::string& symbol) const { return dataset_->symbolTable->find(symbol); }
+    const std::string& getSymbolName(SymbolId id) const { return dataset_->symbolTable->name(id); }
+
+    // The loaded bars, shared rather than copied: copies of this DataManager
+    // and cursors opened on it hold the same dataset. Reloading replaces it.
+    std::shared_ptr<const MarketDataset> getDataset() const { return dataset_; }
+    // A new replay from the first tick of the loaded data, independent of this
+    // DataManager's own getNextBars position. Costs O(symbols), not O(bars).
+    ReplayCursor openReplay() const { return dataLoaded_ ? ReplayCursor(dataset_) : ReplayCursor(); }
+
     // Changed: This now returns the snapshot directly for the Backtester to wrap in an event
     DataSnapshot getNextBars();
+    // Refills `snapshot` in place with the bars of the next timestamp; once the
+    // snapshot has been sized for the symbol table this does not allocate.
+    // Returns false (with `snapshot` empty) when no data is left.
+    bool getNextBars(DataSnapshot& snapshot);
 
     std::chrono::system_clock::time_point getCurrentTime() const;
     bool isDataFinished() const;
+    // Merged replay order of the loaded bars; slots are indices into getAllSymbols().
+    const MasterTimeline& getTimeline() const { return dataset_->timeline; }
 
     // NEW: Setter to limit maximum rows to load (for testing)
     void setMaxRowsToLoad(size_t max_rows) { max_rows_to_load_ = max_rows; }
     size_t getMaxRowsToLoad() const { return max_rows_to_load_; }
 
+    // Worker threads used by loadData to parse symbol files concurrently.
+    // 0 = one per hardware thread, 1 = parse files sequentially on the caller
+    // (and let openChunkedFeed parse chunks on the replay thread).
+    void setLoaderThreads(size_t threads) { loader_threads_ = threads; }
+    size_t getLoaderThreads() const { return loader_threads_; }
+
+    // How loadData reads the data files. Mmap maps each file while a loader
+    // thread parses it, so a cold page cache is read one page fault at a time.
+    // IoUring reads the files through one io_uring (data/BulkFileReader.h),
+    // many large reads in flight at once, and hands each file to a loader
+    // thread as it completes. Falls back to Mmap where io_uring is unavailable;
+    // files that have a bar cache entry or are seeked through a time index are
+    // still mapped, since only part of them is read.
+    enum class FileReader { Mmap, IoUring };
+    void setFileReader(FileReader reader) { file_reader_ = reader; }
+    FileReader getFileReader() const { return file_reader_; }
+
+    // Paging hints for the CSV and bar cache files loadData maps and the bar
+    // arrays it fills (data/PageHints.h). Off by default.
+    void setPageHints(const PageHints& hints) { page_hints_ = hints; }
+    const PageHints& getPageHints() const { return page_hints_; }
+    // Page faults taken while the last loadData ran. Counted for the whole
+    // process, so anything running alongside the load is included.
+    const PageFaults& getLoadPageFaults() const { return load_page_faults_; }
+
+    // Fixed UTC offset of the wall-clock date/time columns in the CSV files
+    // (default 0: the files are in UTC). Applied to every subsequent load.
+    void setTimestampUtcOffset(std::chrono::seconds offset) {
+        timestamp_utc_offset_ = offset;
+        row_timestamp_parser_ = TimestampParser(offset);
+    }
+    std::chrono::seconds getTimestampUtcOffset() const { return timestamp_utc_offset_; }
+
+    // Directory for the binary columnar bar cache (data/BarCache.h); empty = disabled.
+    // Fully parsed CSV files are cached there and mapped back on later loads
+    // as long as the source file is unchanged.
+    void setBarCacheDir(const std::string& dir) { bar_cache_dir_ = dir; }
+    const std::string& getBarCacheDir() const { return bar_cache_dir_; }
+
     // Enable streaming mode with state preservation
     void enableStreamingMode(size_t warmup_buffer = 200) {
         streaming_mode_ = true;
         warmup_buffer_size_ = warmup_buffer;
     }
     
-    // Load data with continuity preservation
+    // Load data with continuity preservation: appends data rows [chunk_start,
+    // chunk_start + chunk_size) of every file (chunk_size 0 = to the end).
+    // Each file's read position is remembered, so requesting consecutive
+    // chunks parses every row once and a full streamed pass is linear.
+    // getNextBars then continues after the last tick it returned; the first
+    // chunk (chunk_start 0) restarts the replay.
     bool loadDataWithContinuity(const std::string& data_dir, size_t chunk_start = 0, size_t chunk_size = 0);
     
     // Get warmup data for strategy initialization
     std::vector<PriceBar> getWarmupData(const std::string& symbol, size_t lookback) const;
 
+    // Out-of-core replay of the CSV files in dataPath for Backtester's
+    // MergeCursor constructor. Each file is read chunkRows rows at a time and
+    // only the current chunk is held, so memory stays bounded by chunkRows x
+    // symbols however long the files are. Unless the loader is limited to
+    // one thread (setLoaderThreads), a pool of up to that many threads parses
+    // each file's next chunk while the current one is replayed, which doubles
+    // the chunk memory. Nothing is loaded into this DataManager; its row cap and UTC
+    // offset apply. Rows older than the previous bar of their file are
+    // skipped, since a stream cannot be sorted.
+    // Returns nullptr if dataPath is not a readable directory.
+    std::unique_ptr<MergeCursor> openChunkedFeed(const std::string& dataPath, size_t chunkRows) const;
+
 private:
-    // Internal storage remains unordered_map for performance
-    std::unordered_map<std::string, std::vector<PriceBar>> historicalData_;
-    std::unordered_map<std::string, size_t> currentIndices_;
-    std::chrono::system_clock::time_point currentTime_ = std::chrono::system_clock::time_point::min();
-    std::vector<std::string> symbols_;
+    // Bars, symbols and replay timeline of the current load. Shared with
+    // copies of this DataManager and with ReplayCursors; written through
+    // mutableDataset(), which copies it first if anyone else holds it (the
+    // series themselves are shared by the copy until they are written).
+    std::shared_ptr<MarketDataset> dataset_ = std::make_shared<MarketDataset>();
+    std::unordered_map<std::string, TickSize> tick_sizes_; // Configured tick sizes (setTickSize)
+    BarStorage bar_storage_ = BarStorage::Rows;
     bool dataLoaded_ = false;
     size_t max_rows_to_load_;
+
+    // Replay state of getNextBars.
+    ReplayCursor replay_;
     
     // State preservation for streaming
-    std::map<std::string, size_t> last_processed_index_;
+    // Where the next streamed chunk of each symbol's file starts.
+    struct StreamCursor {
+        size_t byteOffset = 0; // Start of the next unread row; 0 = not opened yet
+        size_t row = 0;        // Data rows (excluding the header) consumed so far
+    };
+    std::map<std::string, StreamCursor> stream_cursors_;
+    class ChunkedCsvStream; // BarStream over one file, see openChunkedFeed
     std::map<std::string, PriceBar> last_bar_per_symbol_;
     bool streaming_mode_;
     size_t warmup_buffer_size_;
+    size_t loader_threads_;
+    FileReader file_reader_ = FileReader::Mmap;
+    PageHints page_hints_;
+    PageFaults load_page_faults_;
+    std::chrono::seconds timestamp_utc_offset_{0};
+    TimestampParser row_timestamp_parser_; // Used by parseCsvFileWithContinuity (streaming path)
+    std::string bar_cache_dir_;
+    // Sparse time indexes of the CSV files parsed in full, keyed by path. Kept
+    // across loads; an index is only used while its file is unchanged.
+    std::unordered_map<std::string, TimeIndex> time_indexes_;
+
+    // A file parsed by a symbol load, kept for later symbol loads: the
+    // symbol's series in the layouts stored then, shared with that dataset.
+    struct SymbolFile {
+        std::filesystem::file_time_type mtime;
+        uintmax_t size = 0;
+        size_t rowCap = 0;
+        std::chrono::seconds utcOffset{0};
+        size_t dataEnd = 0;
+        BarStorage storage = BarStorage::Rows;
+        size_t barCount = 0;
+        MarketDataset::SharedSeries<std::vector<PriceBar>> rows;
+        MarketDataset::SharedSeries<BarColumns> columns;
+        MarketDataset::SharedSeries<CompressedBars> compressed;
+        MarketDataset::SharedSeries<TickColumns> ticks;
+
+        SymbolFile() = default;
+        SymbolFile(const std::filesystem::path& path, size_t cap, std::chrono::seconds offset, size_t end)
+            : rowCap(cap), utcOffset(offset), dataEnd(end) {
+            std::error_code ec;
+            mtime = std::filesystem::last_write_time(path, ec);
+            size = std::filesystem::file_size(path, ec);
+        }
+        bool matches(const std::filesystem::path& path, size_t cap, std::chrono::seconds offset) const {
+            std::error_code ec;
+            return cap == rowCap && offset == utcOffset && std::filesystem::file_size(path, ec) == size &&
+                   std::filesystem::last_write_time(path, ec) == mtime;
+        }
+    };
+    std::unordered_map<std::string, SymbolFile> symbol_files_; // Keyed by path
+    std::map<std::string, std::map<Timeframe, ResampledSeries>> resampled_; // By symbol, then timeframe
+
+    // How far each file of the current load has been read, for refreshData.
+    struct FileTail {
+        std::string symbol;
+        size_t offset = 0; // Start of the first row not read yet
+        uintmax_t size = 0;
+        std::filesystem::file_time_type mtime;
+    };
+    std::map<std::string, FileTail> file_tails_; // Keyed by path
+    void followFile(const std::string& path, const std::string& symbol, size_t dataEnd);
+
+    // Diagnostics are buffered per file while parsing so that files parsed on
+    // worker threads can be reported in directory order afterwards.
+    struct LoadMessage {
+        bool is_error;
+        std::string text;
+    };
+    struct ParsedCsvFile {
+        std::string path;
+        std::string symbol;
+        std::vector<PriceBar> bars;
+        std::vector<LoadMessage> messages;
+        TimeIndex index; // Empty unless the file was parsed in full and in order
+        size_t dataEnd = 0; // End of the last complete (newline-terminated) row when mapped
+        bool ok = false; // false = the file could not be read at all
+    };
+
+    // Result of parsing one newline-aligned byte range of a CSV file. Row
+    // numbers are local to the range until the ranges are stitched together.
+    struct RowMessage {
+        size_t row;         // 1-based row within the range
+        std::string detail; // Text following "Skipping row N in <file>"
+    };
+    struct CsvRangeResult {
+        std::vector<PriceBar> bars;
+        std::vector<size_t> barRows; // Local row of each bar; only kept when a row cap is set
+        std::vector<RowMessage> messages;
+        std::vector<TimeIndex::Entry> indexEntries; // Every TimeIndex::STRIDE-th bar, local row numbers
+        size_t rowsScanned = 0;
+        bool sorted = true;          // Bars are in non-decreasing timestamp order
+    };
+    // Files smaller than this are never split across threads.
+    static constexpr size_t MIN_PARALLEL_CHUNK_BYTES = size_t(4) << 20;
+
+    using SeriesView = MarketDataset::SeriesView;
+    SeriesView findSeries(const std::string& symbol) const { return dataset_->findSeries(symbol); }
+    MarketDataset& mutableDataset();
+
+    void buildTimeline();
+    // Merges the rows from firstRows[slot] on (0 for symbols added since) into
+    // the timeline and resumes the replay at `position`, the tick after
+    // `replayedUpTo` if the timeline had to be rebuilt instead.
+    void extendTimeline(std::vector<size_t> firstRows, size_t position, TimePoint replayedUpTo);
+    void resetReplay();
+    bool storesRows() const { return bar_storage_ == BarStorage::Rows || bar_storage_ == BarStorage::RowsAndColumns; }
+    bool storesColumns() const { return bar_storage_ == BarStorage::Columns || bar_storage_ == BarStorage::RowsAndColumns; }
+    bool storesCompressed() const { return bar_storage_ == BarStorage::Compressed; }
+    bool storesTicks() const { return bar_storage_ == BarStorage::Ticks; }
+
+    // Replace / extend / drop a symbol's bars in every stored layout.
+    void storeBars(const std::string& symbol, std::vector<PriceBar>&& bars);
+    void appendBars(const std::string& symbol, std::vector<PriceBar>::const_iterator first,
+                    std::vector<PriceBar>::const_iterator last);
+    void eraseBars(const std::string& symbol);
+    // Keeps `symbol`'s series of the current dataset in symbol_files_ for `path`.
+    void keepSymbolFile(const std::filesystem::path& path, const std::string& symbol, size_t dataEnd);
+    // Stores a kept file's series: shared as they are if they were stored in the
+    // current layout (and tick size), otherwise converted.
+    void reuseSymbolFile(const SymbolFile& file, const std::string& symbol);
 
     // --- Private Helper Methods ---
     std::string extractSymbolFromFilename(const std::string& filename) const;
     bool parseCsvFile(const std::string& filename);
+    // Thread-safe: touches no DataManager state besides configuration.
+    // Large files are split into `threads` newline-aligned ranges parsed concurrently.
+    // With a time window only the bars in [windowStart, windowEnd) are kept, read from
+    // the bar cache or the file's time index when possible and the row cap is ignored.
+    // `follow`: the file will be followed by refreshData, so a last row without
+    // a newline is left for it (and the file is neither cached nor indexed).
+    // `contents`: the file's bytes if already read (BulkFileReader); empty = map the file.
+    ParsedCsvFile parseCsvFileToBars(const std::string& filename, size_t threads = 1,
+                                     TimePoint windowStart = TimePoint::min(),
+                                     TimePoint windowEnd = TimePoint::max(),
+                                     bool follow = false,
+                                     std::string_view contents = {}) const;
+    CsvRangeResult parseCsvRange(const char* data, size_t begin, size_t end, size_t rowCap) const;
+    // Body of a .csv.gz / .csv.zst file: parses each inflated block as it arrives.
+    bool parseCompressedCsv(const char* data, size_t size, CsvInflater::Codec codec, size_t rowCap,
+                            const std::string& fileLabel, ParsedCsvFile& result,
+                            bool& inOrder, bool& reachedCap) const;
+    // Shared body of the loadData overloads; `symbols` is null for a full load.
+    bool loadFiles(const std::string& dataPath, TimePoint start, TimePoint end, const std::vector<std::string>* symbols);
+    // Prints the buffered diagnostics and moves the bars into the dataset.
+    bool storeParsedFile(ParsedCsvFile&& parsed);
     
     // Streaming support methods
     bool parseCsvFileWithContinuity(const std::string& file_path, size_t chunk_start, size_t chunk_size);
+    // Decodes the data rows of data[0, size) that follow `cursor`: skips ahead to
+    // row `skipTo` undecoded, then reads up to `maxRows` rows (0 = all) without
+    // passing row `rowCap`. Bars go to `out`, row errors to std::cerr. Advances
+    // `cursor` and returns the number of rows read, including malformed ones.
+    static size_t readStreamRows(const char* data, size_t size, StreamCursor& cursor, size_t skipTo,
+                                 size_t maxRows, size_t rowCap, TimestampParser& timestampParser,
+                                 const std::string& label, std::vector<PriceBar>& out);
     
-    template<typename RowType>
-    PriceBar parseRowToBar(const RowType& row, const std::string& symbol) {
-        std::vector<std::string> cells;
-        for (const auto& cell : row) {
-            std::string cell_view;
-            cell.read_value(cell_view);
-            cells.push_back(cell_view);
-        }
-        
-        if (cells.size() < 6) {
-            throw std::runtime_error("Insufficient columns in CSV row");
-        }
-        
-        // Parse timestamp
-        std::tm tm = {};
-        std::string timestamp_str = cells[0];
-        std::istringstream ss(timestamp_str);
-        ss >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
-        
-        if (ss.fail()) {
-            throw std::runtime_error("Failed to parse timestamp: " + timestamp_str);
-        }
-        
-        std::time_t timestamp = std::mktime(&tm);
-        
-        // Parse OHLCV values with validation
-        double open = std::stod(cells[1]);
-        double high = std::stod(cells[2]);
-        double low = std::stod(cells[3]);
-        double close = std::stod(cells[4]);
-        double volume = std::stod(cells[5]);
-        
-        // Basic data validation
-        if (high < low || open <= 0 || close <= 0 || volume < 0) {
-            throw std::runtime_error("Invalid OHLCV data");
-        }
-        
-        auto chrono_timestamp = std::chrono::system_clock::from_time_t(timestamp);
-        return PriceBar{chrono_timestamp, open, high, low, close, static_cast<long long>(volume)};
-    }
+    // Column layout of the symbol CSV files: open,high,low,close,volume,date_only,time_only
+    static constexpr size_t OPEN_IDX = 0, HIGH_IDX = 1, LOW_IDX = 2, CLOSE_IDX = 3,
+                            VOLUME_IDX = 4, DATE_IDX = 5, TIME_IDX = 6;
+    static constexpr size_t EXPECTED_COLUMNS = 7;
+
+    // Outcome of decoding one CSV row; anything but Ok means the row is skipped.
+    enum class RowStatus { Ok, BadNumber, BadTimestamp, NonPositive, HighBelowLow, OutsideRange };
+
+    // Converts the cells of one row into a bar without allocating or throwing.
+    // On BadNumber/BadTimestamp, badField is set to the offending cell.
+    static RowStatus decodeBarRow(const std::string_view (&cells)[EXPECTED_COLUMNS], PriceBar& bar,
+                                  std::string_view& badField, TimestampParser& timestampParser);
+    static const char* describeRowStatus(RowStatus status);
+
     
     void initializeSimulationState();
+    // Gives every entry of symbols_ an ID, keeping the IDs already issued.
+    void internSymbols(bool freshTable);
 };
\ No newline at end of file
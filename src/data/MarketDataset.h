@@ -0,0 +1,82 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "data/PriceBar.h"
+#include "data/BarColumns.h"
+#include "data/CompressedBars.h"
+#include "data/TickPrices.h"
+#include "data/MasterTimeline.h"
+#include "core/SymbolTable.h"
+
+/**
+ * @brief The bars of one load, shared read-only by everything that replays them.
+ *
+ * DataManager fills a MarketDataset while loading and afterwards hands it out
+ * only as shared_ptr<const MarketDataset>. Copies of the DataManager and every
+ * ReplayCursor opened on it share the same bars instead of copying them. A
+ * later load starts a new dataset, and appending to a shared one copies it
+ * first, so holders of the old pointer keep a consistent view.
+ *
+ * Each symbol's bars are held in exactly the layouts DataManager's BarStorage
+ * asked for; the maps of the other layouts are empty. Every series is itself
+ * shared and never changed in place while another dataset (or DataManager's
+ * per-file cache of symbol loads) holds it, so copying a dataset copies
+ * pointers, not bars.
+ */
+struct MarketDataset {
+    // Read access to one symbol's bars in whichever layout is stored.
+    struct SeriesView {
+        const std::vector<PriceBar>* rows = nullptr;
+        const BarColumns* columns = nullptr;
+        const TickColumns* ticks = nullptr;
+        CompressedBars::Reader compressed; // Keeps its last decoded block
+
+        explicit operator bool() const { return rows || columns || ticks || compressed; }
+        size_t size() const {
+            return rows ? rows->size() : columns ? columns->size() : ticks ? ticks->size() : compressed.size();
+        }
+        std::chrono::system_clock::time_point timestamp(size_t i) const {
+            return rows ? (*rows)[i].timestamp : columns ? columns->timestamp[i]
+                 : ticks ? ticks->timestamp[i] : compressed[i].timestamp;
+        }
+        PriceBar bar(size_t i) const {
+            return rows ? (*rows)[i] : columns ? columns->bar(i) : ticks ? ticks->bar(i) : compressed[i];
+        }
+    };
+
+    template <typename Series>
+    using SharedSeries = std::shared_ptr<const Series>;
+
+    std::unordered_map<std::string, SharedSeries<std::vector<PriceBar>>> rows; // BarStorage::Rows
+    std::unordered_map<std::string, SharedSeries<BarColumns>> columns;          // BarStorage::Columns
+    std::unordered_map<std::string, SharedSeries<CompressedBars>> compressed;   // BarStorage::Compressed
+    std::unordered_map<std::string, SharedSeries<TickColumns>> ticks;           // BarStorage::Ticks
+
+    std::vector<std::string> symbols;  // Sorted by name once the load completes
+    std::vector<SymbolId> symbolIds;   // symbolIds[i] is the ID of symbols[i]
+    std::shared_ptr<const SymbolTable> symbolTable = std::make_shared<SymbolTable>();
+    MasterTimeline timeline;           // Replay order; slots are indices into symbols
+
+    bool hasBars() const { return !rows.empty() || !columns.empty() || !compressed.empty() || !ticks.empty(); }
+
+    // The symbol's bars, preferring rows, then columns, ticks and compressed blocks.
+    SeriesView findSeries(const std::string& symbol) const {
+        SeriesView view;
+        if (auto it = rows.find(symbol); it != rows.end()) {
+            view.rows = it->second.get();
+        } else if (auto it = columns.find(symbol); it != columns.end()) {
+            view.columns = it->second.get();
+        } else if (auto it = ticks.find(symbol); it != ticks.end()) {
+            view.ticks = it->second.get();
+        } else if (auto it = compressed.find(symbol); it != compressed.end()) {
+            view.compressed = CompressedBars::Reader(it->second.get());
+        }
+        return view;
+    }
+};
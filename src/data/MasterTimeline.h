@@ -0,0 +1,142 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Merged replay order of every loaded bar.
+ *
+ * Built once per load from the per-symbol series (each sorted by timestamp).
+ * Tick t has the timestamp time(t) and the bars entries(t): a {slot, row}
+ * pair per symbol with a bar at that tick, in increasing slot order. The
+ * entries of all ticks are stored back to back (offsets_ delimits them), so
+ * a replay is a linear walk that touches only the symbols present at each
+ * tick.
+ *
+ * The ticks follow the order DataManager has always replayed in: a tick is
+ * the smallest pending timestamp across all symbols, and a symbol with
+ * several bars at the same timestamp contributes one of them per tick.
+ */
+class MasterTimeline {
+public:
+    using TimePoint = std::chrono::system_clock::time_point;
+
+    struct Entry {
+        uint32_t slot; // Index of the series passed to build()
+        uint32_t row;  // Row within that series
+    };
+
+    class EntryRange {
+    public:
+        EntryRange(const Entry* first, const Entry* last) : first_(first), last_(last) {}
+        const Entry* begin() const { return first_; }
+        const Entry* end() const { return last_; }
+        size_t size() const { return static_cast<size_t>(last_ - first_); }
+    private:
+        const Entry* first_;
+        const Entry* last_;
+    };
+
+    /**
+     * @brief Rebuilds the timeline by merging `series`.
+     * @tparam Series anything with size() and timestamp(i), sorted by timestamp.
+     */
+    template <typename Series>
+    void build(const std::vector<Series>& series) {
+        clear();
+        merge(series, std::vector<size_t>(series.size(), 0));
+    }
+
+    /**
+     * @brief Extends the timeline with rows [firstRows[slot], size) of each series.
+     *
+     * The result equals a full build() only if every new row is later than the
+     * last tick, so nothing is appended (and false returned) otherwise.
+     */
+    template <typename Series>
+    bool append(const std::vector<Series>& series, const std::vector<size_t>& firstRows) {
+        for (size_t slot = 0; slot < series.size(); ++slot) {
+            if (firstRows[slot] < series[slot].size() && !times_.empty() &&
+                series[slot].timestamp(firstRows[slot]) <= times_.back()) {
+                return false;
+            }
+        }
+        merge(series, firstRows);
+        return true;
+    }
+
+    void clear() {
+        times_.clear();
+        entries_.clear();
+        offsets_.assign(1, 0);
+        mergedBars_ = 0;
+    }
+
+    size_t size() const { return times_.size(); }
+    bool empty() const { return times_.empty(); }
+    size_t barCount() const { return entries_.size(); }
+    // Bars merged by the last build() or append().
+    size_t mergedBars() const { return mergedBars_; }
+
+    TimePoint time(size_t tick) const { return times_[tick]; }
+    EntryRange entries(size_t tick) const {
+        return EntryRange(entries_.data() + offsets_[tick], entries_.data() + offsets_[tick + 1]);
+    }
+    // Index of the first tick later than `t` (size() if there is none).
+    size_t firstTickAfter(TimePoint t) const {
+        return static_cast<size_t>(std::upper_bound(times_.begin(), times_.end(), t) - times_.begin());
+    }
+
+private:
+    // Appends the ticks of rows [firstRows[slot], size) of each series.
+    template <typename Series>
+    void merge(const std::vector<Series>& series, const std::vector<size_t>& firstRows) {
+        size_t newRows = 0;
+        for (size_t slot = 0; slot < series.size(); ++slot) newRows += series[slot].size() - firstRows[slot];
+        mergedBars_ = newRows;
+        // Grow geometrically so that repeated appends stay linear overall.
+        entries_.reserve(std::max(entries_.size() + newRows, 2 * entries_.capacity()));
+
+        // Min-heap of the next pending row of each series, ordered by (timestamp, slot).
+        using Head = std::pair<TimePoint, uint32_t>;
+        std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heap;
+        std::vector<uint32_t> nextRow(firstRows.begin(), firstRows.end());
+        for (uint32_t slot = 0; slot < series.size(); ++slot) {
+            if (nextRow[slot] < series[slot].size()) heap.emplace(series[slot].timestamp(nextRow[slot]), slot);
+        }
+
+        std::vector<uint32_t> repeated; // Slots whose next row repeats the current timestamp
+        while (!heap.empty()) {
+            const TimePoint tickTime = heap.top().first;
+            times_.push_back(tickTime);
+            while (!heap.empty() && heap.top().first == tickTime) {
+                const uint32_t slot = heap.top().second;
+                heap.pop();
+                const uint32_t row = nextRow[slot]++;
+                entries_.push_back({slot, row});
+                if (nextRow[slot] < series[slot].size()) {
+                    const TimePoint next = series[slot].timestamp(nextRow[slot]);
+                    if (next == tickTime) {
+                        repeated.push_back(slot); // Goes into the next tick
+                    } else {
+                        heap.emplace(next, slot);
+                    }
+                }
+            }
+            offsets_.push_back(entries_.size());
+            for (uint32_t slot : repeated) heap.emplace(tickTime, slot);
+            repeated.clear();
+        }
+    }
+
+    std::vector<TimePoint> times_;
+    std::vector<Entry> entries_;
+    std::vector<size_t> offsets_ = {0}; // Tick t owns entries_[offsets_[t], offsets_[t + 1])
+    size_t mergedBars_ = 0;
+};
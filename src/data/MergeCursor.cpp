@@ -0,0 +1,74 @@
+#include "MergeCursor.h"
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+SymbolId MergeCursor::addStream(std::unique_ptr<BarStream> stream) {
+    if (!stream) {
+        throw std::invalid_argument("MergeCursor: null stream");
+    }
+    if (symbol_table_->find(stream->symbol()) != INVALID_SYMBOL_ID) {
+        throw std::invalid_argument("MergeCursor: duplicate stream for symbol " + stream->symbol());
+    }
+    // Copy-on-write: tables already handed out (e.g. to a Backtester) never change.
+    if (symbol_table_.use_count() > 1) {
+        symbol_table_ = std::make_shared<SymbolTable>(*symbol_table_);
+    }
+    const SymbolId id = symbol_table_->intern(stream->symbol());
+    sources_.push_back({std::move(stream), PriceBar{}});
+    if (advance(id)) {
+        pushHead(id);
+    }
+    return id;
+}
+
+bool MergeCursor::getNextBars(DataSnapshot& snapshot) {
+    snapshot.clear();
+    if (heap_.empty()) {
+        return false;
+    }
+    if (snapshot.slots() < sources_.size()) {
+        snapshot.resize(sources_.size());
+    }
+
+    current_time_ = heap_.front().first;
+    while (!heap_.empty() && heap_.front().first == current_time_) {
+        const SymbolId id = popHead().second;
+        snapshot.set(id, sources_[id].head);
+        if (advance(id)) {
+            if (sources_[id].head.timestamp == current_time_) {
+                repeated_.push_back(id); // One bar per symbol and tick; the rest go to the next tick
+            } else {
+                pushHead(id);
+            }
+        }
+    }
+    for (SymbolId id : repeated_) {
+        pushHead(id);
+    }
+    repeated_.clear();
+    return true;
+}
+
+bool MergeCursor::advance(SymbolId id) {
+    Source& source = sources_[id];
+    if (!source.stream) return false;
+    if (!source.stream->next(source.head)) {
+        source.stream.reset(); // Release the stream's resources as soon as it is drained
+        return false;
+    }
+    return true;
+}
+
+void MergeCursor::pushHead(SymbolId id) {
+    heap_.emplace_back(sources_[id].head.timestamp, id);
+    std::push_heap(heap_.begin(), heap_.end(), std::greater<Head>());
+}
+
+MergeCursor::Head MergeCursor::popHead() {
+    std::pop_heap(heap_.begin(), heap_.end(), std::greater<Head>());
+    Head head = heap_.back();
+    heap_.pop_back();
+    return head;
+}
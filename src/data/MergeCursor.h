@@ -0,0 +1,70 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "data/BarStream.h"
+#include "core/DataSnapshot.h"
+#include "core/SymbolTable.h"
+
+/**
+ * @brief k-way merge of BarStreams into per-timestamp snapshots.
+ *
+ * The head bar of every stream sits in a binary min-heap keyed by
+ * (timestamp, SymbolId). getNextBars pops the k heads that share the smallest
+ * timestamp and refills each from its stream, so a tick costs O(k log n) for
+ * n streams instead of a scan over all of them. Universes of thousands of
+ * symbols where only a few tick at a time stay cheap.
+ *
+ * Snapshots come out exactly as DataManager's in-memory replay produces them:
+ * one tick per distinct timestamp, and a stream with several bars at the same
+ * timestamp contributes one of them per tick. Each stream's symbol is interned
+ * in the order the streams are added; add them in name order to get the
+ * SymbolIds DataManager would issue.
+ *
+ * A cursor is single-pass: it consumes its streams and cannot be rewound.
+ */
+class MergeCursor {
+public:
+    using TimePoint = std::chrono::system_clock::time_point;
+
+    /**
+     * @brief Registers `stream` and reads its first bar.
+     * @return The SymbolId given to the stream's symbol.
+     * @throws std::invalid_argument if the stream is null or its symbol was already added.
+     */
+    SymbolId addStream(std::unique_ptr<BarStream> stream);
+
+    std::shared_ptr<const SymbolTable> getSymbolTable() const { return symbol_table_; }
+    size_t streamCount() const { return sources_.size(); }
+
+    // Fills `snapshot` with the bars of the next timestamp; false once every stream is exhausted.
+    bool getNextBars(DataSnapshot& snapshot);
+
+    // Timestamp of the last snapshot (min() before the first one).
+    TimePoint getCurrentTime() const { return current_time_; }
+    // Timestamp the next snapshot will have (max() when finished).
+    TimePoint peekNextTime() const { return heap_.empty() ? TimePoint::max() : heap_.front().first; }
+    bool isFinished() const { return heap_.empty(); }
+
+private:
+    struct Source {
+        std::unique_ptr<BarStream> stream;
+        PriceBar head; // Next bar of the stream, valid while it is queued
+    };
+    using Head = std::pair<TimePoint, SymbolId>;
+
+    // Reads the next bar of `id` into its head slot; false if the stream is done.
+    bool advance(SymbolId id);
+    void pushHead(SymbolId id);
+    Head popHead();
+
+    std::vector<Source> sources_; // Indexed by SymbolId
+    std::vector<Head> heap_;      // Min-heap (std::greater) of the queued heads
+    std::vector<SymbolId> repeated_; // Streams whose next bar repeats the current timestamp
+    std::shared_ptr<SymbolTable> symbol_table_ = std::make_shared<SymbolTable>();
+    TimePoint current_time_ = TimePoint::min();
+};
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Kernel paging hints for the files the loader maps and the bar arrays it fills.
+ *
+ * `sequential` and `willNeed` apply to mapped CSV and bar cache files.
+ * MADV_SEQUENTIAL makes readahead aggressive and lets pages behind the parser
+ * be reclaimed first. MADV_WILLNEED starts reading the whole file as soon as
+ * it is mapped instead of faulting it in page by page.
+ *
+ * `hugePages` asks for transparent huge pages (MADV_HUGEPAGE) on the loaded
+ * bar arrays before they are written, so they are faulted in and replayed in
+ * 2 MiB pages: the parsed rows, every BarColumns and TickColumns column and
+ * the encoded bytes of CompressedBars. Buffers that grow afterwards (bars
+ * appended by refreshData or a streamed chunk) and series copied on write are
+ * not advised again. It only takes effect where
+ * /sys/kernel/mm/transparent_hugepage/enabled is "always" or "madvise".
+ *
+ * Every hint is a no-op outside Linux.
+ */
+struct PageHints {
+    bool sequential = false;
+    bool willNeed = false;
+    bool hugePages = false;
+
+    bool any() const { return sequential || willNeed || hugePages; }
+
+    // Applies `sequential` and `willNeed` to the mapping [data, data + size).
+    void adviseMapping(const void* data, size_t size) const {
+#if defined(__linux__)
+        if (size == 0 || (!sequential && !willNeed)) return;
+        const uintptr_t page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+        const uintptr_t begin = reinterpret_cast<uintptr_t>(data) & ~(page - 1);
+        const size_t length = reinterpret_cast<uintptr_t>(data) + size - begin;
+        if (sequential) madvise(reinterpret_cast<void*>(begin), length, MADV_SEQUENTIAL);
+        if (willNeed) madvise(reinterpret_cast<void*>(begin), length, MADV_WILLNEED);
+#else
+        (void)data;
+        (void)size;
+#endif
+    }
+
+    // v.reserve(count), asking for huge pages on the new buffer before it is
+    // first written. Only the whole 2 MiB pages inside the buffer qualify.
+    template <typename T>
+    void reserve(std::vector<T>& v, size_t count) const {
+        v.reserve(count);
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        if (!hugePages || v.capacity() == 0) return;
+        constexpr uintptr_t HUGE_PAGE = uintptr_t(2) << 20;
+        const uintptr_t start = reinterpret_cast<uintptr_t>(v.data());
+        const uintptr_t begin = (start + HUGE_PAGE - 1) & ~(HUGE_PAGE - 1);
+        const uintptr_t end = (start + v.capacity() * sizeof(T)) & ~(HUGE_PAGE - 1);
+        if (end > begin) madvise(reinterpret_cast<void*>(begin), end - begin, MADV_HUGEPAGE);
+#endif
+    }
+};
+
+/**
+ * @brief Page faults taken by the whole process (all threads), from getrusage.
+ *
+ * Minor faults map a page that is already in memory; major faults wait for
+ * the disk. The difference of two samples measures the work in between.
+ */
+struct PageFaults {
+    long minor = 0;
+    long major = 0;
+
+    static PageFaults now() {
+        PageFaults faults;
+#if defined(__linux__)
+        rusage usage{};
+        if (getrusage(RUSAGE_SELF, &usage) == 0) {
+            faults.minor = usage.ru_minflt;
+            faults.major = usage.ru_majflt;
+        }
+#endif
+        return faults;
+    }
+
+    PageFaults operator-(const PageFaults& earlier) const {
+        return {minor - earlier.minor, major - earlier.major};
+    }
+};
@@ -52,6 +52,9 @@ struct PriceBar {
      * represents UTC, this might lead to incorrect time_point values depending on your
      * system's timezone settings.
      *
+     * DataManager does not use this on its load path; it parses the CSV columns with
+     * TimestampParser (data/TimestampParser.h), which is allocation-free and timezone-independent.
+     *
      * Throws std::runtime_error on parsing or conversion failure.
      *
      * @param dateStr The date string (e.g., "4/1/25").
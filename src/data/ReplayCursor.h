@@ -0,0 +1,78 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "data/MarketDataset.h"
+#include "core/DataSnapshot.h"
+
+/**
+ * @brief One replay position over a shared MarketDataset.
+ *
+ * Holds the dataset pointer, the series of each timeline slot and the next
+ * tick, so opening a cursor costs O(symbols) however many bars the dataset
+ * has. Any number of cursors can replay the same dataset independently.
+ */
+class ReplayCursor {
+public:
+    using TimePoint = std::chrono::system_clock::time_point;
+
+    ReplayCursor() = default;
+    explicit ReplayCursor(std::shared_ptr<const MarketDataset> dataset) : dataset_(std::move(dataset)) {
+        if (!dataset_) return;
+        views_.reserve(dataset_->symbols.size());
+        for (const auto& symbol : dataset_->symbols) {
+            views_.push_back(dataset_->findSeries(symbol));
+        }
+        rewind();
+    }
+
+    const std::shared_ptr<const MarketDataset>& dataset() const { return dataset_; }
+
+    // Fills `snapshot` with the bars of the next tick; false (with `snapshot`
+    // empty) once the timeline is exhausted.
+    bool getNextBars(DataSnapshot& snapshot) {
+        snapshot.clear();
+        if (isFinished()) {
+            return false;
+        }
+        const MarketDataset& data = *dataset_;
+        if (snapshot.slots() < data.symbolTable->size()) {
+            snapshot.resize(data.symbolTable->size());
+        }
+        const size_t tick = next_tick_++;
+        current_time_ = data.timeline.time(tick);
+        for (const MasterTimeline::Entry& entry : data.timeline.entries(tick)) {
+            snapshot.set(data.symbolIds[entry.slot], views_[entry.slot].bar(entry.row));
+        }
+        return !snapshot.empty();
+    }
+
+    // Timestamp of the last tick returned; before the first one, that of the first tick.
+    TimePoint getCurrentTime() const { return current_time_; }
+    bool isFinished() const { return !dataset_ || next_tick_ >= dataset_->timeline.size(); }
+
+    // Restarts the replay from the first tick.
+    void rewind() { seek(0); }
+
+    // Index of the next tick getNextBars returns; seek() continues from `tick`.
+    size_t position() const { return next_tick_; }
+    void seek(size_t tick) {
+        next_tick_ = tick;
+        if (!dataset_ || dataset_->timeline.empty()) {
+            current_time_ = TimePoint::min();
+        } else {
+            current_time_ = dataset_->timeline.time(tick > 0 ? std::min(tick, dataset_->timeline.size()) - 1 : 0);
+        }
+    }
+
+private:
+    std::shared_ptr<const MarketDataset> dataset_;
+    std::vector<MarketDataset::SeriesView> views_; // Series of each timeline slot
+    size_t next_tick_ = 0;
+    TimePoint current_time_ = TimePoint::min();
+};
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <vector>
+
+#include "data/PageHints.h"
+#include "data/PriceBar.h"
+
+// A price as a whole number of ticks of its symbol's TickSize.
+using Ticks = int64_t;
+
+/**
+ * @brief Conversion between double prices and integer ticks.
+ *
+ * For decimal ticks (0.01, 0.0001, ...) and other ticks that divide 1 evenly
+ * (0.25, 0.125) prices are converted through the whole number of ticks per
+ * unit, so toPrice(toTicks(p)) returns exactly the double the CSV parser
+ * produced for every price that lies on the tick grid.
+ */
+class TickSize {
+public:
+    TickSize() : TickSize(0.01) {}
+    explicit TickSize(double size) : size_(size) {
+        const double perUnit = std::round(1.0 / size);
+        if (perUnit >= 1.0 && std::fabs(perUnit * size - 1.0) < 1e-12) per_unit_ = perUnit;
+    }
+    // 10^-digits.
+    static TickSize decimal(int digits) { return TickSize(std::pow(10.0, -digits)); }
+
+    double size() const { return size_; }
+    Ticks toTicks(double price) const { return std::llround(per_unit_ > 0 ? price * per_unit_ : price / size_); }
+    double toPrice(Ticks ticks) const {
+        return per_unit_ > 0 ? static_cast<double>(ticks) / per_unit_ : static_cast<double>(ticks) * size_;
+    }
+    // True if `price` lies on the tick grid (converts back to the same double).
+    bool isExact(double price) const { return toPrice(toTicks(price)) == price; }
+
+    static constexpr int MAX_DIGITS = 8;
+
+    // The coarsest decimal tick, down to 10^-maxDigits, on which every price of
+    // `bars` lies; nullopt if there is none.
+    static std::optional<TickSize> infer(const std::vector<PriceBar>& bars, int maxDigits = MAX_DIGITS) {
+        for (int digits = 0; digits <= maxDigits; ++digits) {
+            const TickSize tick = decimal(digits);
+            bool exact = true;
+            for (size_t i = 0; exact && i < bars.size(); ++i) {
+                exact = tick.isExact(bars[i].Open) && tick.isExact(bars[i].High) &&
+                        tick.isExact(bars[i].Low) && tick.isExact(bars[i].Close);
+            }
+            if (exact) return tick;
+        }
+        return std::nullopt;
+    }
+
+private:
+    double size_;
+    double per_unit_ = 0.0; // Ticks per unit of price when that is a whole number, else 0
+};
+
+/**
+ * @brief Struct-of-arrays storage for one symbol's bars with prices in ticks.
+ *
+ * The layout of BarColumns with int64 tick prices, so comparisons and sums
+ * over a price column are exact integer operations. bar(i) converts back to a
+ * PriceBar for code that works in doubles.
+ */
+struct TickColumns {
+    TickSize tick;
+    std::vector<std::chrono::system_clock::time_point> timestamp;
+    std::vector<Ticks> open;
+    std::vector<Ticks> high;
+    std::vector<Ticks> low;
+    std::vector<Ticks> close;
+    std::vector<long long> volume;
+    size_t rounded_prices = 0; // Prices that were off the tick grid and rounded on the way in
+
+    size_t size() const { return timestamp.size(); }
+    bool empty() const { return timestamp.empty(); }
+
+    void reserve(size_t n, const PageHints& hints = {}) {
+        hints.reserve(timestamp, n);
+        hints.reserve(open, n);
+        hints.reserve(high, n);
+        hints.reserve(low, n);
+        hints.reserve(close, n);
+        hints.reserve(volume, n);
+    }
+
+    void push_back(const PriceBar& bar) {
+        timestamp.push_back(bar.timestamp);
+        open.push_back(convert(bar.Open));
+        high.push_back(convert(bar.High));
+        low.push_back(convert(bar.Low));
+        close.push_back(convert(bar.Close));
+        volume.push_back(bar.Volume);
+    }
+
+    template <typename It>
+    void append(It first, It last) {
+        const size_t needed = size() + static_cast<size_t>(std::distance(first, last));
+        if (needed > timestamp.capacity()) {
+            reserve(std::max(needed, 2 * timestamp.capacity())); // Stay geometric across appends
+        }
+        for (; first != last; ++first) push_back(*first);
+    }
+
+    // Reassembles bar i as a PriceBar.
+    PriceBar bar(size_t i) const {
+        PriceBar b;
+        b.timestamp = timestamp[i];
+        b.Open = tick.toPrice(open[i]);
+        b.High = tick.toPrice(high[i]);
+        b.Low = tick.toPrice(low[i]);
+        b.Close = tick.toPrice(close[i]);
+        b.Volume = volume[i];
+        return b;
+    }
+
+    static TickColumns fromRows(const std::vector<PriceBar>& rows, TickSize tick, const PageHints& hints = {}) {
+        TickColumns columns;
+        columns.tick = tick;
+        columns.reserve(rows.size(), hints);
+        columns.append(rows.begin(), rows.end());
+        return columns;
+    }
+
+private:
+    Ticks convert(double price) {
+        const Ticks ticks = tick.toTicks(price);
+        if (tick.toPrice(ticks) != price) ++rounded_prices;
+        return ticks;
+    }
+};
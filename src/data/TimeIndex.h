@@ -0,0 +1,76 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+#include "data/BarCache.h"
+
+/**
+ * @brief Sparse timestamp -> byte offset index of one chronological CSV file.
+ *
+ * Holds the timestamp, byte offset and row number of every STRIDE-th bar.
+ * DataManager builds it while parsing a file in full and keeps it across
+ * reloads, so a later loadData(path, start, end) parses only the byte range
+ * between the entries that bracket the window instead of the whole history.
+ * The index is tied to the exact file contents through a BarCache stamp and
+ * is only built for files whose rows are already in timestamp order.
+ */
+class TimeIndex {
+public:
+    using TimePoint = std::chrono::system_clock::time_point;
+    static constexpr size_t STRIDE = 1024;
+
+    struct Entry {
+        TimePoint timestamp;
+        size_t offset; // Byte offset where the bar's row starts
+        size_t row;    // 1-based row number in the file (the header is row 1)
+    };
+
+    // Byte range holding every bar with start <= timestamp < end.
+    struct Range {
+        size_t begin;
+        size_t end;
+        size_t rowsBefore; // Rows of the file before `begin`, header included
+    };
+
+    TimeIndex() = default;
+    TimeIndex(const BarCache::SourceStamp& source, size_t dataStart, size_t fileSize)
+        : source_(source), data_start_(dataStart), file_size_(fileSize) {}
+
+    // Entries must be added in file order.
+    void add(const Entry& entry) { entries_.push_back(entry); }
+
+    bool matches(const BarCache::SourceStamp& source) const {
+        return source.size == source_.size && source.mtime == source_.mtime && source.checksum == source_.checksum;
+    }
+
+    Range locate(TimePoint start, TimePoint end) const {
+        Range range{data_start_, file_size_, 1};
+        // The last sampled bar before `start`: every earlier row is before the window too.
+        auto first = std::lower_bound(entries_.begin(), entries_.end(), start,
+                                      [](const Entry& e, TimePoint t) { return e.timestamp < t; });
+        if (first != entries_.begin()) {
+            --first;
+            range.begin = first->offset;
+            range.rowsBefore = first->row - 1;
+        }
+        // The first sampled bar at or after `end`: it and every later row are past the window.
+        auto last = std::lower_bound(entries_.begin(), entries_.end(), end,
+                                     [](const Entry& e, TimePoint t) { return e.timestamp < t; });
+        if (last != entries_.end()) {
+            range.end = std::max(range.begin, last->offset);
+        }
+        return range;
+    }
+
+    size_t size() const { return entries_.size(); }
+    bool empty() const { return entries_.empty(); }
+
+private:
+    BarCache::SourceStamp source_;
+    size_t data_start_ = 0;
+    size_t file_size_ = 0;
+    std::vector<Entry> entries_;
+};
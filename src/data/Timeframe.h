@@ -0,0 +1,57 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+
+/**
+ * @brief A bar length plus the time of day its buckets are aligned to.
+ *
+ * Buckets start at the session open and then every `period`, and never span
+ * two sessions: the last bucket of a session is cut short at the next open.
+ * With the default open of 00:00 UTC, periods that divide a day (1m, 5m,
+ * 15m, 1h, ...) give clock-aligned buckets. Periods of a day or more give one
+ * bar per session. Bars are stamped with the start of their bucket.
+ */
+struct Timeframe {
+    using TimePoint = std::chrono::system_clock::time_point;
+
+    std::chrono::seconds period{60};
+    std::chrono::seconds session_open{0}; // UTC time of day the sessions start at
+
+    static Timeframe seconds(long n, std::chrono::seconds open = {}) { return {std::chrono::seconds(n), open}; }
+    static Timeframe minutes(long n, std::chrono::seconds open = {}) { return {std::chrono::minutes(n), open}; }
+    static Timeframe hours(long n, std::chrono::seconds open = {}) { return {std::chrono::hours(n), open}; }
+
+    // Start of the bucket `t` falls in.
+    TimePoint bucketStart(TimePoint t) const {
+        using Day = std::chrono::duration<long long, std::ratio<86400>>;
+        const auto sinceOpen = t.time_since_epoch() - session_open;
+        const TimePoint session(std::chrono::floor<Day>(sinceOpen) + session_open);
+        if (period >= Day(1) || period <= std::chrono::seconds(0)) {
+            return session;
+        }
+        const auto intoSession = t - session;
+        return session + (intoSession / period) * period;
+    }
+
+    // "30s", "5m", "1h", "1d"; a session open other than midnight is appended ("1h@13:30").
+    std::string label() const {
+        const long long s = period.count();
+        std::string text = s % 86400 == 0 ? std::to_string(s / 86400) + "d"
+                         : s % 3600 == 0  ? std::to_string(s / 3600) + "h"
+                         : s % 60 == 0    ? std::to_string(s / 60) + "m"
+                                          : std::to_string(s) + "s";
+        if (session_open.count() != 0) {
+            const long long open = session_open.count();
+            const long long minutes = (open / 60) % 60;
+            text += "@" + std::to_string(open / 3600) + (minutes < 10 ? ":0" : ":") + std::to_string(minutes);
+        }
+        return text;
+    }
+
+    bool operator==(const Timeframe& o) const { return period == o.period && session_open == o.session_open; }
+    bool operator!=(const Timeframe& o) const { return !(*this == o); }
+    bool operator<(const Timeframe& o) const {
+        return period != o.period ? period < o.period : session_open < o.session_open;
+    }
+};
@@ -0,0 +1,128 @@
+#ifndef TIMESTAMPPARSER_H
+#define TIMESTAMPPARSER_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+/**
+ * @brief Allocation-free parser for the CSV "YYYY-MM-DD" + "HH:MM:SS" timestamp columns.
+ *
+ * Converts straight to seconds since the epoch with days-from-civil arithmetic
+ * instead of std::get_time + std::mktime, so it never consults the process
+ * timezone. The wall-clock values are interpreted at a fixed UTC offset
+ * (0 = the data is already UTC; -4h = US Eastern daylight time, etc.).
+ *
+ * Consecutive rows almost always share a date, so the day number of the last
+ * date string is cached. One parser per thread: the cache is not synchronized.
+ */
+class TimestampParser {
+public:
+    explicit TimestampParser(std::chrono::seconds utcOffset = std::chrono::seconds(0))
+        : utcOffsetSeconds_(utcOffset.count()) {}
+
+    /**
+     * @brief Parses a date and a time cell into a system_clock time point.
+     *
+     * Month, day and hour may be written with one or two digits; minutes and
+     * seconds must have two. Surrounding whitespace must already be trimmed.
+     * @return false (leaving `out` untouched) if either field is malformed.
+     */
+    bool parse(std::string_view date, std::string_view time, std::chrono::system_clock::time_point& out) {
+        int64_t dayNumber = 0;
+        if (hasCachedDate_ && date.size() == cachedDateLength_ &&
+            std::memcmp(date.data(), cachedDate_, date.size()) == 0) {
+            dayNumber = cachedDayNumber_;
+        } else {
+            if (!parseDate(date, dayNumber)) return false;
+            if (date.size() <= sizeof(cachedDate_)) {
+                std::memcpy(cachedDate_, date.data(), date.size());
+                cachedDateLength_ = date.size();
+                cachedDayNumber_ = dayNumber;
+                hasCachedDate_ = true;
+            }
+        }
+
+        int64_t secondOfDay = 0;
+        if (!parseTime(time, secondOfDay)) return false;
+
+        const int64_t epochSeconds = dayNumber * 86400 + secondOfDay - utcOffsetSeconds_;
+        out = std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::seconds(epochSeconds)));
+        return true;
+    }
+
+    std::chrono::seconds utcOffset() const { return std::chrono::seconds(utcOffsetSeconds_); }
+
+    /**
+     * @brief Days since 1970-01-01 for a proleptic Gregorian date.
+     *        (Howard Hinnant's days_from_civil.)
+     */
+    static constexpr int64_t daysFromCivil(int64_t y, unsigned m, unsigned d) {
+        y -= m <= 2;
+        const int64_t era = (y >= 0 ? y : y - 399) / 400;
+        const unsigned yoe = static_cast<unsigned>(y - era * 400);                // [0, 399]
+        const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;      // [0, 365]
+        const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;               // [0, 146096]
+        return era * 146097 + static_cast<int64_t>(doe) - 719468;
+    }
+
+private:
+    // Reads 1..maxDigits digits starting at pos; advances pos past them.
+    static bool readNumber(std::string_view s, size_t& pos, size_t minDigits, size_t maxDigits, unsigned& value) {
+        size_t digits = 0;
+        value = 0;
+        while (pos < s.size() && digits < maxDigits && s[pos] >= '0' && s[pos] <= '9') {
+            value = value * 10 + static_cast<unsigned>(s[pos] - '0');
+            ++pos;
+            ++digits;
+        }
+        return digits >= minDigits;
+    }
+
+    static bool expect(std::string_view s, size_t& pos, char c) {
+        if (pos >= s.size() || s[pos] != c) return false;
+        ++pos;
+        return true;
+    }
+
+    static bool isLeapYear(unsigned y) { return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0; }
+
+    static bool parseDate(std::string_view s, int64_t& dayNumber) {
+        static constexpr unsigned DAYS_IN_MONTH[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+        size_t pos = 0;
+        unsigned y = 0, m = 0, d = 0;
+        if (!readNumber(s, pos, 4, 4, y) || !expect(s, pos, '-') ||
+            !readNumber(s, pos, 1, 2, m) || !expect(s, pos, '-') ||
+            !readNumber(s, pos, 1, 2, d) || pos != s.size()) {
+            return false;
+        }
+        if (m < 1 || m > 12 || d < 1) return false;
+        const unsigned monthDays = DAYS_IN_MONTH[m - 1] + ((m == 2 && isLeapYear(y)) ? 1 : 0);
+        if (d > monthDays) return false;
+        dayNumber = daysFromCivil(y, m, d);
+        return true;
+    }
+
+    static bool parseTime(std::string_view s, int64_t& secondOfDay) {
+        size_t pos = 0;
+        unsigned h = 0, mi = 0, se = 0;
+        if (!readNumber(s, pos, 1, 2, h) || !expect(s, pos, ':') ||
+            !readNumber(s, pos, 2, 2, mi) || !expect(s, pos, ':') ||
+            !readNumber(s, pos, 2, 2, se) || pos != s.size()) {
+            return false;
+        }
+        if (h > 23 || mi > 59 || se > 60) return false; // 60 allows a leap second, as %S does
+        secondOfDay = static_cast<int64_t>(h) * 3600 + mi * 60 + se;
+        return true;
+    }
+
+    int64_t utcOffsetSeconds_;
+    char cachedDate_[16] = {};
+    size_t cachedDateLength_ = 0;
+    int64_t cachedDayNumber_ = 0;
+    bool hasCachedDate_ = false;
+};
+
+#endif // TIMESTAMPPARSER_H
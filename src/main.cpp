@@ -24,15 +24,34 @@
 #include <functional> // For std::function
 #include <filesystem> // For checking data dir existence
 #include <limits>
+#include <optional>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <sstream>
 
 // --- StrategyResult struct defined in Portfolio.h ---
 #include "core/Portfolio.h" // Make sure this is included
+#include "core/Utils.h" // rank_correlation, random_sample_indices
 
 // --- Global Data Cache ---
 std::map<std::string, std::unique_ptr<DataManager>> cached_data_managers;
 
 // --- Global Configuration (CLI) ---
 static size_t GLOBAL_MAX_ROWS_TO_LOAD = std::numeric_limits<size_t>::max();
+static size_t GLOBAL_LOADER_THREADS = 0; // 0 = one per hardware thread
+static std::string GLOBAL_BAR_CACHE_DIR; // empty = no bar cache; otherwise <dir>/<dataset name>
+static size_t GLOBAL_OUT_OF_CORE_CHUNK_ROWS = 0; // 0 = load every dataset into memory
+static bool GLOBAL_COMPRESS_BARS = false; // Keep cached datasets as CompressedBars
+static bool GLOBAL_TICK_PRICES = false;   // Keep cached datasets as int64 tick prices
+static bool GLOBAL_LAZY_SYMBOLS = false;  // Load only each strategy's required_symbols() per run
+static bool GLOBAL_IO_URING = false;      // Read data files through io_uring instead of mmap
+static bool GLOBAL_PAGE_HINTS_SET = false; // --page-hints given: apply the hints and report page faults per load
+static PageHints GLOBAL_PAGE_HINTS;
+static long GLOBAL_SCREEN_MINUTES = 0;    // Coarse screening level in minutes; 0 = run every configuration at full resolution
+static double GLOBAL_SCREEN_KEEP = 0.2;   // Fraction of the screened configurations re-run at full resolution
+static size_t GLOBAL_SCREEN_SAMPLE = 0;   // Configurations drawn from all screened ones to check the ranking; 0 = use the kept ones
 
 // --- Helper Function to Build Data Path ---
 std::string build_data_path(const std::string& base_dir, const std::string& subdir_name) {
@@ -54,16 +73,65 @@ DataManager* get_cached_data_manager(const std::string& data_path) {
     if (GLOBAL_MAX_ROWS_TO_LOAD != std::numeric_limits<size_t>::max()) {
         data_manager->setMaxRowsToLoad(GLOBAL_MAX_ROWS_TO_LOAD);
     }
-    if (!data_manager->loadData(data_path)) {
+    data_manager->setLoaderThreads(GLOBAL_LOADER_THREADS);
+    if (GLOBAL_IO_URING) {
+        data_manager->setFileReader(DataManager::FileReader::IoUring);
+    }
+    data_manager->setPageHints(GLOBAL_PAGE_HINTS);
+    if (GLOBAL_COMPRESS_BARS) {
+        data_manager->setBarStorage(DataManager::BarStorage::Compressed);
+    } else if (GLOBAL_TICK_PRICES) {
+        data_manager->setBarStorage(DataManager::BarStorage::Ticks);
+    }
+    if (!GLOBAL_BAR_CACHE_DIR.empty()) {
+        std::filesystem::path cache_dir = std::filesystem::path(GLOBAL_BAR_CACHE_DIR) / std::filesystem::path(data_path).filename();
+        data_manager->setBarCacheDir(cache_dir.string());
+    }
+    if (GLOBAL_LAZY_SYMBOLS) {
+        // Nothing is loaded up front; each run loads the symbols it subscribes to.
+    } else if (!data_manager->loadData(data_path)) {
         std::cerr << "Failed to load data from: " << data_path << std::endl;
         return nullptr;
     }
+    if (GLOBAL_PAGE_HINTS_SET && !GLOBAL_LAZY_SYMBOLS) {
+        const PageFaults& faults = data_manager->getLoadPageFaults();
+        std::cout << "[MEMORY] Page faults while loading " << data_path << ": " << faults.minor << " minor, "
+                  << faults.major << " major." << std::endl;
+    }
     
     DataManager* ptr = data_manager.get();
     cached_data_managers[data_path] = std::move(data_manager);
     return ptr;
 }
 
+// --- Helper Function to Run One Configuration Quietly on Loaded Data (screening pass) ---
+std::optional<StrategyResult> run_configuration(const DataManager& data,
+                                                const std::function<std::unique_ptr<Strategy>()>& factory,
+                                                double initial_cash) {
+    try {
+        std::unique_ptr<Strategy> strategy = factory();
+        if (!strategy) return std::nullopt;
+        Backtester backtester(data, std::move(strategy), initial_cash);
+        Portfolio const* portfolio = backtester.run_and_get_portfolio();
+        if (portfolio) return portfolio->get_results_summary();
+    } catch (const std::exception& e) {
+        std::cerr << "Error during screening run: " << e.what() << std::endl;
+    }
+    return std::nullopt;
+}
+
+// --- Per-Dataset Record of a Coarse-to-Fine Screening Pass ---
+struct ScreeningReport {
+    std::string dataset;
+    std::string level;       // Timeframe label of the coarse pass, e.g. "5m"
+    size_t screened = 0;     // Configurations run at the coarse level
+    size_t kept = 0;         // Of those, re-run at full resolution
+    double coarse_seconds = 0.0;
+    double fine_seconds = 0.0;
+    size_t sampled = 0;      // Configurations drawn at random for rank_correlation; 0 = the kept ones
+    double rank_correlation = 0.0; // Spearman rho of coarse vs full-resolution returns over those
+};
+
 int main(int argc, char* argv[]) {
     // --- Parse CLI Args for optional row cap BEFORE anything else accesses the cache ---
     for(int i=1; i<argc; ++i){
@@ -77,10 +145,108 @@ int main(int argc, char* argv[]) {
                 GLOBAL_MAX_ROWS_TO_LOAD = std::numeric_limits<size_t>::max();
             }
         }
+        const std::string threads_prefix = "--load-threads=";
+        if(arg.rfind(threads_prefix,0)==0){
+            try {
+                GLOBAL_LOADER_THREADS = std::stoull(arg.substr(threads_prefix.size()));
+            } catch(const std::exception& ex) {
+                std::cerr << "[WARN] Invalid --load-threads value ('" << arg.substr(threads_prefix.size()) << "'): " << ex.what() << ". Using all hardware threads." << std::endl;
+                GLOBAL_LOADER_THREADS = 0;
+            }
+        }
+        const std::string cache_prefix = "--bar-cache=";
+        if(arg.rfind(cache_prefix,0)==0){
+            GLOBAL_BAR_CACHE_DIR = arg.substr(cache_prefix.size());
+        }
+        if(arg=="--compress-bars"){
+            GLOBAL_COMPRESS_BARS = true;
+        }
+        if(arg=="--tick-prices"){
+            GLOBAL_TICK_PRICES = true;
+        }
+        if(arg=="--lazy-symbols"){
+            GLOBAL_LAZY_SYMBOLS = true;
+        }
+        if(arg=="--io-uring"){
+            GLOBAL_IO_URING = true;
+        }
+        const std::string hints_prefix = "--page-hints=";
+        if(arg.rfind(hints_prefix,0)==0){
+            GLOBAL_PAGE_HINTS_SET = true;
+            std::stringstream hints(arg.substr(hints_prefix.size()));
+            std::string hint;
+            while (std::getline(hints, hint, ',')) {
+                if (hint == "sequential") GLOBAL_PAGE_HINTS.sequential = true;
+                else if (hint == "willneed") GLOBAL_PAGE_HINTS.willNeed = true;
+                else if (hint == "hugepages") GLOBAL_PAGE_HINTS.hugePages = true;
+                else if (hint != "none") std::cerr << "[WARN] Unknown --page-hints value '" << hint << "' ignored." << std::endl;
+            }
+        }
+        const std::string screen_prefix = "--screen=";
+        if(arg.rfind(screen_prefix,0)==0){
+            try {
+                GLOBAL_SCREEN_MINUTES = std::stol(arg.substr(screen_prefix.size()));
+            } catch(const std::exception& ex) {
+                std::cerr << "[WARN] Invalid --screen value ('" << arg.substr(screen_prefix.size()) << "'): " << ex.what() << ". Screening disabled." << std::endl;
+                GLOBAL_SCREEN_MINUTES = 0;
+            }
+        }
+        const std::string keep_prefix = "--screen-keep=";
+        if(arg.rfind(keep_prefix,0)==0){
+            try {
+                GLOBAL_SCREEN_KEEP = std::min(1.0, std::max(0.0, std::stod(arg.substr(keep_prefix.size()))));
+            } catch(const std::exception& ex) {
+                std::cerr << "[WARN] Invalid --screen-keep value ('" << arg.substr(keep_prefix.size()) << "'): " << ex.what() << ". Keeping the top 20%." << std::endl;
+                GLOBAL_SCREEN_KEEP = 0.2;
+            }
+        }
+        const std::string sample_prefix = "--screen-sample=";
+        if(arg.rfind(sample_prefix,0)==0){
+            try {
+                GLOBAL_SCREEN_SAMPLE = std::stoull(arg.substr(sample_prefix.size()));
+            } catch(const std::exception& ex) {
+                std::cerr << "[WARN] Invalid --screen-sample value ('" << arg.substr(sample_prefix.size()) << "'): " << ex.what() << ". Correlating the kept configurations only." << std::endl;
+                GLOBAL_SCREEN_SAMPLE = 0;
+            }
+        }
+        const std::string ooc_prefix = "--out-of-core=";
+        if(arg.rfind(ooc_prefix,0)==0){
+            try {
+                GLOBAL_OUT_OF_CORE_CHUNK_ROWS = std::stoull(arg.substr(ooc_prefix.size()));
+            } catch(const std::exception& ex) {
+                std::cerr << "[WARN] Invalid --out-of-core value ('" << arg.substr(ooc_prefix.size()) << "'): " << ex.what() << ". Loading data into memory." << std::endl;
+                GLOBAL_OUT_OF_CORE_CHUNK_ROWS = 0;
+            }
+        }
+    }
+    if(GLOBAL_COMPRESS_BARS && GLOBAL_TICK_PRICES){
+        std::cerr << "[WARN] --compress-bars and --tick-prices select different bar storages; using compressed bars, --tick-prices ignored." << std::endl;
+        GLOBAL_TICK_PRICES = false;
     }
     if(GLOBAL_MAX_ROWS_TO_LOAD!=std::numeric_limits<size_t>::max()){
         std::cout << "[CONFIG] Row cap set via CLI: " << GLOBAL_MAX_ROWS_TO_LOAD << " rows per CSV." << std::endl;
     }
+    if(GLOBAL_PAGE_HINTS_SET){
+        std::cout << "[CONFIG] Page hints:" << (GLOBAL_PAGE_HINTS.sequential ? " sequential" : "")
+                  << (GLOBAL_PAGE_HINTS.willNeed ? " willneed" : "") << (GLOBAL_PAGE_HINTS.hugePages ? " hugepages" : "")
+                  << (GLOBAL_PAGE_HINTS.any() ? "" : " none") << "; page faults reported per dataset load." << std::endl;
+    }
+    if(GLOBAL_OUT_OF_CORE_CHUNK_ROWS>0){
+        std::cout << "[CONFIG] Out-of-core replay: " << GLOBAL_OUT_OF_CORE_CHUNK_ROWS << " rows per chunk." << std::endl;
+    }
+    if(GLOBAL_SCREEN_MINUTES>0){
+        if(GLOBAL_OUT_OF_CORE_CHUNK_ROWS>0 || GLOBAL_LAZY_SYMBOLS){
+            std::cerr << "[WARN] --screen needs every dataset loaded in memory; ignored with --out-of-core and --lazy-symbols." << std::endl;
+            GLOBAL_SCREEN_MINUTES = 0;
+        } else {
+            std::cout << "[CONFIG] Screening every configuration on " << GLOBAL_SCREEN_MINUTES << "-minute bars, re-running the top "
+                      << GLOBAL_SCREEN_KEEP * 100.0 << "% at full resolution." << std::endl;
+            if(GLOBAL_SCREEN_SAMPLE>0){
+                std::cout << "[CONFIG] Checking the screening ranking on " << GLOBAL_SCREEN_SAMPLE
+                          << " configurations drawn at random, dropped ones included." << std::endl;
+            }
+        }
+    }
 
     // --- UPDATED TITLE ---
     std::cout << "--- HFT Backtesting System - COMPREHENSIVE Multi-Strategy & Multi-Dataset Testing ---" << std::endl;
@@ -100,6 +266,7 @@ int main(int argc, char* argv[]) {
     // --- Map to Store All Results ---
     // Key: Combined name like "StrategyName_on_DataSetName"
     std::map<std::string, StrategyResult> all_results;
+    std::vector<ScreeningReport> screening_reports;
 
     // --- OUTER LOOP: Iterate Through Datasets ---
     for (const std::string& target_dataset_subdir : datasets_to_test) {
@@ -117,16 +284,24 @@ int main(int argc, char* argv[]) {
         }
 
         // --- Get or Load Cached Data WITH WARMUP SUPPORT ---
-        DataManager* cached_data = get_cached_data_manager(data_path);
-        if (!cached_data) {
-            std::cerr << "ERROR: Failed to load data for '" << data_path << "'. Skipping dataset." << std::endl;
-            continue;
-        }
-        
-        // Enable streaming mode for large datasets
-        if (GLOBAL_MAX_ROWS_TO_LOAD != std::numeric_limits<size_t>::max()) {
-            cached_data->enableStreamingMode(200); // 200-bar warmup buffer
-            std::cout << "[INFO] Enabled streaming mode with " << GLOBAL_MAX_ROWS_TO_LOAD << " row limit." << std::endl;
+        DataManager* cached_data = nullptr;
+        std::optional<std::vector<std::string>> lazy_symbols; // Symbols cached_data holds in --lazy-symbols mode
+        DataManager stream_source; // Out-of-core mode: opens a chunked feed per run instead
+        if (GLOBAL_OUT_OF_CORE_CHUNK_ROWS > 0) {
+            stream_source.setMaxRowsToLoad(GLOBAL_MAX_ROWS_TO_LOAD);
+            stream_source.setLoaderThreads(GLOBAL_LOADER_THREADS); // 1 = no chunk prefetch
+        } else {
+            cached_data = get_cached_data_manager(data_path);
+            if (!cached_data) {
+                std::cerr << "ERROR: Failed to load data for '" << data_path << "'. Skipping dataset." << std::endl;
+                continue;
+            }
+
+            // Enable streaming mode for large datasets
+            if (GLOBAL_MAX_ROWS_TO_LOAD != std::numeric_limits<size_t>::max()) {
+                cached_data->enableStreamingMode(200); // 200-bar warmup buffer
+                std::cout << "[INFO] Enabled streaming mode with " << GLOBAL_MAX_ROWS_TO_LOAD << " row limit." << std::endl;
+            }
         }
 
         // --- Define Symbol Names BASED ON CURRENT DATASET ---
@@ -365,6 +540,61 @@ int main(int argc, char* argv[]) {
          }
          std::cout << std::endl;
 
+        // --- Coarse-to-Fine Screening: rank every configuration on coarser bars, keep the best ---
+        std::map<std::string, double> coarse_returns; // By configuration name
+        std::optional<ScreeningReport> screening;
+        std::vector<StrategyConfig> sample; // Drawn from every screened configuration for the rank correlation
+        if (GLOBAL_SCREEN_MINUTES > 0) {
+            const Timeframe level = Timeframe::minutes(GLOBAL_SCREEN_MINUTES);
+            const auto screen_start = std::chrono::steady_clock::now();
+            DataManager coarse_data;
+            if (!coarse_data.loadResampled(*cached_data, level)) {
+                std::cerr << "ERROR: Could not resample '" << data_path << "' to " << level.label() << ". Running every configuration." << std::endl;
+            } else {
+                std::vector<std::pair<double, size_t>> ranked; // (coarse return, configuration index)
+                for (size_t i = 0; i < strategies_to_run_this_dataset.size(); ++i) {
+                    const auto& config = strategies_to_run_this_dataset[i];
+                    std::cout << "\n[SCREEN] " << config.name << " on " << level.label() << " bars" << std::endl;
+                    if (auto result = run_configuration(coarse_data, config.factory, initial_cash)) {
+                        coarse_returns[config.name] = result->total_return_pct;
+                        ranked.push_back({result->total_return_pct, i});
+                    }
+                }
+                std::stable_sort(ranked.begin(), ranked.end(),
+                                 [](const auto& a, const auto& b) { return a.first > b.first; });
+                const size_t keep = std::min(ranked.size(), std::max<size_t>(1, static_cast<size_t>(
+                                                 std::ceil(GLOBAL_SCREEN_KEEP * ranked.size()))));
+                std::vector<bool> kept(strategies_to_run_this_dataset.size(), false);
+                for (size_t r = 0; r < keep; ++r) kept[ranked[r].second] = true;
+                std::vector<StrategyConfig> survivors;
+                for (size_t i = 0; i < strategies_to_run_this_dataset.size(); ++i) {
+                    if (kept[i]) survivors.push_back(strategies_to_run_this_dataset[i]);
+                }
+
+                // The kept configurations alone are the top of the coarse ranking, so
+                // their rho says little about the ones the cut dropped.
+                if (GLOBAL_SCREEN_SAMPLE > 0) {
+                    for (size_t r : random_sample_indices(ranked.size(), GLOBAL_SCREEN_SAMPLE, 42)) {
+                        sample.push_back(strategies_to_run_this_dataset[ranked[r].second]);
+                    }
+                }
+
+                ScreeningReport report;
+                report.dataset = target_dataset_subdir;
+                report.level = level.label();
+                report.screened = ranked.size();
+                report.kept = survivors.size();
+                report.sampled = sample.size();
+                report.coarse_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - screen_start).count();
+                screening = report;
+                std::cout << "\n[SCREEN] Kept " << survivors.size() << " of " << ranked.size() << " configurations for '"
+                          << target_dataset_subdir << "' after the " << level.label() << " pass ("
+                          << std::fixed << std::setprecision(1) << report.coarse_seconds << "s)." << std::defaultfloat << std::endl;
+                strategies_to_run_this_dataset = std::move(survivors);
+            }
+        }
+        const auto fine_start = std::chrono::steady_clock::now();
+
         // --- INNER LOOP: Iterate Through Applicable Strategies for this Dataset ---
         for (const auto& config : strategies_to_run_this_dataset) {
             std::cout << "\n\n===== Running Strategy: " << config.name << " on Dataset: " << target_dataset_subdir << " =====" << std::endl;
@@ -379,11 +609,34 @@ int main(int argc, char* argv[]) {
             if (!strategy) { continue; } // Should not happen with factory, but safety check
 
             // Create a new Backtester for each specific run - but use cached data
-            Backtester backtester(*cached_data, std::move(strategy), initial_cash);
+            // (or, out of core, a fresh chunked feed over the files)
+            std::unique_ptr<Backtester> backtester;
+            if (GLOBAL_OUT_OF_CORE_CHUNK_ROWS > 0) {
+                std::unique_ptr<MergeCursor> feed = stream_source.openChunkedFeed(data_path, GLOBAL_OUT_OF_CORE_CHUNK_ROWS);
+                if (!feed) {
+                    std::cerr << "ERROR: Failed to open '" << data_path << "' for out-of-core replay. Skipping." << std::endl;
+                    continue;
+                }
+                backtester = std::make_unique<Backtester>(std::move(feed), std::move(strategy), initial_cash);
+            } else {
+                if (GLOBAL_LAZY_SYMBOLS) {
+                    std::vector<std::string> symbols = strategy->required_symbols();
+                    std::sort(symbols.begin(), symbols.end());
+                    if (lazy_symbols != symbols) {
+                        lazy_symbols.reset();
+                        if (!cached_data->loadData(data_path, symbols)) {
+                            std::cerr << "ERROR: Failed to load the symbols of '" << config.name << "'. Skipping." << std::endl;
+                            continue;
+                        }
+                        lazy_symbols = std::move(symbols);
+                    }
+                }
+                backtester = std::make_unique<Backtester>(*cached_data, std::move(strategy), initial_cash);
+            }
             Portfolio const* result_portfolio = nullptr;
 
             try {
-                result_portfolio = backtester.run_and_get_portfolio();
+                result_portfolio = backtester->run_and_get_portfolio();
             } catch (const std::exception& e) {
                 std::cerr << "FATAL ERROR during backtest for '" << config.name << "' on '" << target_dataset_subdir << "': " << e.what() << std::endl;
                 continue; // Skip to next strategy
@@ -403,6 +656,32 @@ int main(int argc, char* argv[]) {
 
         } // End INNER strategy loop
 
+        if (screening) {
+            screening->fine_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - fine_start).count();
+            // Sampled configurations the cut dropped are run at full resolution for the correlation only.
+            const std::vector<StrategyConfig>& correlated = screening->sampled > 0 ? sample : strategies_to_run_this_dataset;
+            std::vector<double> coarse, fine;
+            for (const auto& config : correlated) {
+                if (!coarse_returns.count(config.name)) continue;
+                auto result = all_results.find(config.name + "_on_" + target_dataset_subdir);
+                std::optional<double> fine_return;
+                if (result != all_results.end()) {
+                    fine_return = result->second.total_return_pct;
+                } else if (screening->sampled > 0) {
+                    std::cout << "\n[SCREEN] Checking dropped " << config.name << " at full resolution" << std::endl;
+                    if (auto checked = run_configuration(*cached_data, config.factory, initial_cash)) {
+                        fine_return = checked->total_return_pct;
+                    }
+                }
+                if (fine_return) {
+                    coarse.push_back(coarse_returns[config.name]);
+                    fine.push_back(*fine_return);
+                }
+            }
+            screening->rank_correlation = rank_correlation(coarse, fine);
+            screening_reports.push_back(*screening);
+        }
+
     } // End OUTER dataset loop
 
     // --- Print Combined Comparison Table ---
@@ -436,6 +715,39 @@ int main(int argc, char* argv[]) {
          std::cout << "\nNo strategy results to display." << std::endl;
     }
 
+    // --- Print Screening Summary ---
+    if (!screening_reports.empty()) {
+        std::cout << "\n\n===== Coarse-to-Fine Screening =====" << std::endl;
+        std::cout << std::left << std::setw(16) << "Dataset"
+                  << std::right << std::setw(8) << "Level"
+                  << std::right << std::setw(10) << "Screened"
+                  << std::right << std::setw(8) << "Kept"
+                  << std::right << std::setw(12) << "Coarse (s)"
+                  << std::right << std::setw(12) << "Full (s)"
+                  << std::right << std::setw(14) << "Rank Corr."
+                  << std::right << std::setw(12) << "Over"
+                  << std::endl;
+        std::cout << std::string(92, '-') << std::endl;
+        for (const auto& report : screening_reports) {
+            std::cout << std::left << std::setw(16) << report.dataset
+                      << std::right << std::setw(8) << report.level
+                      << std::right << std::setw(10) << report.screened
+                      << std::right << std::setw(8) << report.kept
+                      << std::fixed << std::setprecision(2)
+                      << std::right << std::setw(12) << report.coarse_seconds
+                      << std::right << std::setw(12) << report.fine_seconds
+                      << std::right << std::setw(14);
+            if (std::isnan(report.rank_correlation)) std::cout << "n/a";
+            else std::cout << report.rank_correlation;
+            std::cout << std::right << std::setw(12)
+                      << (report.sampled > 0 ? std::to_string(report.sampled) + " drawn" : "kept only") << std::endl;
+        }
+        std::cout << std::string(92, '=') << std::endl;
+        std::cout << "Rank correlation is Spearman's rho between the coarse and full-resolution returns. Over the kept"
+                  << " configurations only it is biased by the cut; --screen-sample=N computes it over N configurations"
+                  << " drawn at random from all screened ones." << std::endl;
+    }
+
     std::cout << "\n--- Comprehensive Run Invocation Complete ---" << std::endl;
     return 0;
 }
\ No newline at end of file
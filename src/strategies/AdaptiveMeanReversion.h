@@ -181,7 +181,7 @@ public:
 
     // Main per-bar logic
     void on_data(const PriceBar& bar,
-                 const std::string& sym,
+                 SymbolId sym,
                  EventQueue& q)
     {
         // single early warm-up exit
@@ -11,7 +11,7 @@
 #include <algorithm>
 #include <cmath>
 #include <numeric>
-#include <map>
+#include <unordered_map>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -66,7 +66,7 @@ private:
         MarketRegime current_regime{};
         double current_vol = 0.0;
     };
-    std::map<std::string, SymbolState> states_;
+    std::unordered_map<SymbolId, SymbolState> states_;
     mutable std::mutex state_mutex_;
 
     //――――――――――――――――――――――――――――――――――――――――――――
@@ -14,7 +14,7 @@
 class BuyAndHoldStrategy : public Strategy {
 private:
     // Track which symbols we've already bought
-    std::unordered_map<std::string, bool> positions_taken_;
+    std::unordered_map<SymbolId, bool> positions_taken_;
     
     // Position size (percentage of portfolio)
     const double position_percent_;
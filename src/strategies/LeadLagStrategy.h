@@ -38,6 +38,8 @@ private:
     const double      correlation_threshold_;
     const double      leader_return_threshold_;
     const double      target_position_size_;
+    SymbolId          leading_id_ = INVALID_SYMBOL_ID; // Resolved from the symbol table
+    SymbolId          lagging_id_ = INVALID_SYMBOL_ID;
 
     //――――――――――――――――――――――――――――――――――――――
     // 3) State: rolling return history + O(1) corr-buffers
@@ -121,16 +123,21 @@ public:
             throw std::invalid_argument("Leader and lagger must differ");
     }
 
+    void resolve_symbols() override {
+        leading_id_ = symbol_id(leading_symbol_);
+        lagging_id_ = symbol_id(lagging_symbol_);
+    }
+
     void handle_market_event(const MarketEvent& ev, EventQueue& queue) override {
         if (!portfolio_) return;
 
         // grab bars
-        auto itL = ev.data.find(leading_symbol_);
-        auto itG = ev.data.find(lagging_symbol_);
-        if (itL==ev.data.end() || itG==ev.data.end()) return;
+        const PriceBar* barL = ev.data.get(leading_id_);
+        const PriceBar* barG = ev.data.get(lagging_id_);
+        if (!barL || !barG) return;
 
-        const auto& lb = itL->second;
-        const auto& lg = itG->second;
+        const auto& lb = *barL;
+        const auto& lg = *barG;
         const double   lc = lb.Close;
         const double   gc = lg.Close;
 
@@ -188,13 +195,13 @@ public:
                                    : desired==SignalDirection::SHORT? -target_position_size_
                                    : 0.0);
 
-            double current_qty = portfolio_->get_position_quantity(lagging_symbol_);
+            double current_qty = portfolio_->get_position_quantity(lagging_id_);
             double delta       = target_qty - current_qty;
             if (std::abs(delta) > EPS) {
                 auto dir = delta>0 ? OrderDirection::BUY : OrderDirection::SELL;
                 send_event(std::make_shared<OrderEvent>(
                                ev.timestamp,
-                               lagging_symbol_,
+                               lagging_id_,
                                OrderType::MARKET,
                                dir,
                                std::abs(delta)),
@@ -207,4 +214,6 @@ public:
     void handle_fill_event(const FillEvent&, EventQueue&) override {
         // nothing to do
     }
+
+    std::vector<std::string> required_symbols() const override { return {leading_symbol_, lagging_symbol_}; }
 };
\ No newline at end of file
@@ -192,7 +192,7 @@ public:
         // let's pick the first symbol in the snapshot
         if (ev.data.empty()) return;
         const auto& kv = *ev.data.begin();
-        const std::string sym = kv.first;
+        const SymbolId sym = kv.first;
         const PriceBar& bar  = kv.second;
 
         // update history
@@ -11,7 +11,7 @@
 #include <algorithm>
 #include <cmath>
 #include <iostream>
-#include <map>
+#include <unordered_map>
 #include <numeric>
 #include <stdexcept>
 #include <string>
@@ -48,7 +48,7 @@ private:
 
         SymbolState(size_t max_hist) : hist(max_hist) {}
     };
-    std::map<std::string, SymbolState> states_;
+    std::unordered_map<SymbolId, SymbolState> states_;
 
     //――――――――――――――――――――――――――――――――――
     // 4) Helpers for each condition
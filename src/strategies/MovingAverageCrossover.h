@@ -11,7 +11,7 @@
 #include <algorithm>
 #include <cmath>
 #include <iostream>
-#include <map>
+#include <unordered_map>
 #include <mutex>
 #include <numeric>
 #include <stdexcept>
@@ -58,7 +58,7 @@ private:
         SymbolState(size_t p, size_t v, size_t tr, size_t r) noexcept
           : prices(p), volumes(v), true_ranges(tr), returns(r) {}
     };
-    std::map<std::string, SymbolState> states_;
+    std::unordered_map<SymbolId, SymbolState> states_;
     mutable std::mutex state_mutex_;
 
     //――――――――――――――――――――――――――――――
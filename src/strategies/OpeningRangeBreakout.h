@@ -13,7 +13,7 @@
 #include <cmath>
 #include <iostream>
 #include <limits>
-#include <map>
+#include <unordered_map>
 #include <mutex>
 #include <stdexcept>
 #include <string>
@@ -66,7 +66,7 @@ private:
         SignalDirection current_signal = SignalDirection::FLAT;
     };
 
-    std::map<std::string, SymbolState> states_;
+    std::unordered_map<SymbolId, SymbolState> states_;
     std::mutex                         state_mutex_;
 
     //――――――――――――――――――――――――――――――――――
@@ -170,7 +170,7 @@ public:
             }
             if (!st.range_established) {
                 st.range_established = true;
-                std::cout << "ORB ESTABLISHED: " << symbol << " @ "
+                std::cout << "ORB ESTABLISHED: " << symbol_name(symbol) << " @ "
                           << formatTimestampUTC(ev.timestamp)
                           << " H=" << st.range_high
                           << " L=" << st.range_low << "\n";
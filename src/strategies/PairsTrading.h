@@ -37,9 +37,14 @@ private:
     const double      entry_zscore_threshold_; // Z-entry
     const double      exit_zscore_threshold_;  // Z-exit
     const double      trade_value_;            // $ per leg
+    SymbolId          id_a_ = INVALID_SYMBOL_ID; // Resolved from the symbol table
+    SymbolId          id_b_ = INVALID_SYMBOL_ID;
 
     //――――――――――――――――――――――――――――――――――
     // 3) Runtime state
+    // Each MarketEvent carries one bar per symbol, so closes arrive one at a
+    // time whatever the storage layout; the window keeps only those doubles and
+    // O(1) sums rather than rescanning DataManager's close column every tick.
     circular_buffer<double> ratio_hist_; // size = lookback_window_
     double sum_ratio_    = 0.0;                 // Σ ratio
     double sum_ratio_sq_ = 0.0;                 // Σ ratio²
@@ -74,17 +79,22 @@ public:
     }
 
     //――――――――――――――――――――――――――――――――――
+    void resolve_symbols() override {
+        id_a_ = symbol_id(symbol_a_);
+        id_b_ = symbol_id(symbol_b_);
+    }
+
     void handle_market_event(const MarketEvent& ev, EventQueue& queue) override {
         std::lock_guard lock(mtx_);
         if (!portfolio_) return;
 
         // Fetch both bars
-        auto ita = ev.data.find(symbol_a_);
-        auto itb = ev.data.find(symbol_b_);
-        if (ita == ev.data.end() || itb == ev.data.end()) return;
+        const PriceBar* bar_a = ev.data.get(id_a_);
+        const PriceBar* bar_b = ev.data.get(id_b_);
+        if (!bar_a || !bar_b) return;
 
-        const PriceBar& ba = ita->second;
-        const PriceBar& bb = itb->second;
+        const PriceBar& ba = *bar_a;
+        const PriceBar& bb = *bar_b;
         double pa = ba.Close, pb = bb.Close;
         if (pa <= EPS || pb <= EPS) return;  // guard zero
 
@@ -153,8 +163,8 @@ public:
             }
 
             // Current positions
-            double cur_a = portfolio_->get_position_quantity(symbol_a_);
-            double cur_b = portfolio_->get_position_quantity(symbol_b_);
+            double cur_a = portfolio_->get_position_quantity(id_a_);
+            double cur_b = portfolio_->get_position_quantity(id_b_);
             double da = target_a - cur_a;
             double db = target_b - cur_b;
 
@@ -162,7 +172,7 @@ public:
             if (std::abs(da) > EPS) {
                 send_event(std::make_shared<OrderEvent>(
                     ev.timestamp,
-                    symbol_a_,
+                    id_a_,
                     OrderType::MARKET,
                     da>0 ? OrderDirection::BUY : OrderDirection::SELL,
                     std::abs(da)
@@ -173,7 +183,7 @@ public:
             if (std::abs(db) > EPS) {
                 send_event(std::make_shared<OrderEvent>(
                     ev.timestamp,
-                    symbol_b_,
+                    id_b_,
                     OrderType::MARKET,
                     db>0 ? OrderDirection::BUY : OrderDirection::SELL,
                     std::abs(db)
@@ -187,6 +197,8 @@ public:
     // No special fill logic
     void handle_fill_event(const FillEvent&, EventQueue&) override {}
 
+    std::vector<std::string> required_symbols() const override { return {symbol_a_, symbol_b_}; }
+
     std::string get_name() const override {
         return "CitadelPairsTrading_" + symbol_a_ + "_" + symbol_b_;
     }
@@ -37,9 +37,14 @@ private:
     const double      entry_zscore_threshold_; // to enter
     const double      exit_zscore_threshold_;  // to exit
     const double      max_position_risk_;      // fraction of equity
+    SymbolId          primary_id_ = INVALID_SYMBOL_ID; // Resolved from the symbol table
+    SymbolId          hedge_id_   = INVALID_SYMBOL_ID;
 
     //――――――――――――――――――――――――――――――――――
     // 3) Rolling buffers & running sums for O(1) stats
+    // Fed one close per symbol per MarketEvent, already close-only; a strategy
+    // has no DataManager to take ColumnSpans from, and a window rescan per
+    // tick would cost more than these running sums.
     circular_buffer<double> buf_primary_;      // price A
     circular_buffer<double> buf_hedge_;        // price B
     circular_buffer<double> buf_spread_;       // spread = A - β*B
@@ -87,16 +92,21 @@ public:
     }
 
     //――――――――――――――――――――――――――――――――――
+    void resolve_symbols() override {
+        primary_id_ = symbol_id(primary_symbol_);
+        hedge_id_ = symbol_id(hedge_symbol_);
+    }
+
     void handle_market_event(const MarketEvent& ev, EventQueue& queue) override {
         std::lock_guard<std::mutex> lock(mtx_);
         if (!portfolio_) return;
 
         // 1) fetch bars
-        auto ita = ev.data.find(primary_symbol_);
-        auto itb = ev.data.find(hedge_symbol_);
-        if (ita==ev.data.end()||itb==ev.data.end()) return;
-        double pa = ita->second.Close;
-        double pb = itb->second.Close;
+        const PriceBar* bar_a = ev.data.get(primary_id_);
+        const PriceBar* bar_b = ev.data.get(hedge_id_);
+        if (!bar_a||!bar_b) return;
+        double pa = bar_a->Close;
+        double pb = bar_b->Close;
         if (pa<=EPS || pb<=EPS) return;
 
         // 2) update rolling OLS sums for β = cov(A,B)/var(B)
@@ -189,14 +199,14 @@ public:
             // convert to shares
             double targetA = qa;
             double targetB = qb;
-            double curA = portfolio_->get_position_quantity(primary_symbol_);
-            double curB = portfolio_->get_position_quantity(hedge_symbol_);
+            double curA = portfolio_->get_position_quantity(primary_id_);
+            double curB = portfolio_->get_position_quantity(hedge_id_);
             double dA = targetA - curA;
             double dB = targetB - curB;
 
             if (std::abs(dA)>EPS) {
                 send_event(std::make_shared<OrderEvent>(
-                  ev.timestamp, primary_symbol_,
+                  ev.timestamp, primary_id_,
                   OrderType::MARKET,
                   dA>0?OrderDirection::BUY:OrderDirection::SELL,
                   std::abs(dA)
@@ -204,7 +214,7 @@ public:
             }
             if (std::abs(dB)>EPS) {
                 send_event(std::make_shared<OrderEvent>(
-                  ev.timestamp, hedge_symbol_,
+                  ev.timestamp, hedge_id_,
                   OrderType::MARKET,
                   dB>0?OrderDirection::BUY:OrderDirection::SELL,
                   std::abs(dB)
@@ -219,6 +229,8 @@ public:
         // no-op
     }
 
+    std::vector<std::string> required_symbols() const override { return {primary_symbol_, hedge_symbol_}; }
+
     std::string get_name() const override {
         return "CitadelStatArb_" + primary_symbol_ + "_" + hedge_symbol_;
     }
@@ -15,6 +15,16 @@
 class Strategy {
 protected:
     Portfolio* portfolio_ = nullptr; // Pointer to the portfolio (non-owning)
+    const SymbolTable* symbol_table_ = nullptr; // Symbol names <-> IDs of the loaded data (non-owning)
+
+    // Called whenever the symbol table changes. Strategies that trade fixed,
+    // named symbols look up their SymbolIds here instead of on every bar.
+    virtual void resolve_symbols() {}
+
+    SymbolId symbol_id(const std::string& name) const {
+        return symbol_table_ ? symbol_table_->find(name) : INVALID_SYMBOL_ID;
+    }
+    std::string symbol_name(SymbolId id) const { return symbol_label(symbol_table_, id); }
 
 public:
     // --- Constructor and Virtual Destructor ---
@@ -25,9 +35,20 @@ public:
     virtual void handle_market_event(const MarketEvent& event, EventQueue& queue) = 0;
     virtual void handle_fill_event(const FillEvent& event, EventQueue& queue) {}
     virtual std::string get_name() const { return "Strategy"; }
+    // Symbols the strategy reads; empty = every symbol of the dataset. Lets
+    // the caller load and replay only these (DataManager::loadData(path, symbols)).
+    virtual std::vector<std::string> required_symbols() const { return {}; }
+    // Higher timeframes the strategy reads. The Backtester aggregates every
+    // symbol's bars into these and hands each completed bar over in
+    // MarketEvent::resampled, so strategies need no bar history to downsample.
+    virtual std::vector<Timeframe> required_timeframes() const { return {}; }
 
     // --- Helper for Strategies ---
     void set_portfolio(Portfolio* portfolio) { portfolio_ = portfolio; }
+    void set_symbol_table(const SymbolTable* symbols) {
+        symbol_table_ = symbols;
+        resolve_symbols();
+    }
 
     // --- ADVANCED QUANTITATIVE HELPERS ---
     
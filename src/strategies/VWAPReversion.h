@@ -6,7 +6,7 @@
 #include "core/Utils.h"
 #include "core/Portfolio.h"
 #include <string>
-#include <map>
+#include <unordered_map>
 #include <vector>
 #include <deque>
 #include <cmath> // For std::sqrt, std::pow, std::abs
@@ -27,8 +27,8 @@ private:
         std::deque<double> price_vwap_diffs; // Store recent price-VWAP differences
         int rolling_stddev_window = 50; // Window for std dev calculation
     };
-    std::map<std::string, SymbolState> symbol_state_;
-    std::map<std::string, SignalDirection> current_signal_state_; // Track long/short/flat
+    std::unordered_map<SymbolId, SymbolState> symbol_state_;
+    std::unordered_map<SymbolId, SignalDirection> current_signal_state_; // Track long/short/flat
 
 public:
     VWAPReversion(double deviation_multiplier = 2.0, double target_pos_size = 3.0) // Changed default from 100 to 3
@@ -43,7 +43,7 @@ public:
         if (!portfolio_) return; // Need portfolio access
 
         for (const auto& pair : event.data) {
-            const std::string& symbol = pair.first;
+            const SymbolId symbol = pair.first;
             const PriceBar& bar = pair.second;
 
             // Use a typical price for VWAP calculation (e.g., average of HLC)
@@ -98,7 +98,7 @@ public:
 
             // --- Generate Orders based on Target ---
             if (desired_signal != current_signal_state_[symbol]) {
-                 std::cout << "VWAP REVERSION: " << symbol << " @ " << formatTimestampUTC(event.timestamp)
+                 std::cout << "VWAP REVERSION: " << symbol_name(symbol) << " @ " << formatTimestampUTC(event.timestamp)
                            << " Close=" << bar.Close << " VWAP=" << state.current_vwap
                            << " LowBand=" << lower_band << " UpBand=" << upper_band
                            << " Signal=" << (desired_signal == SignalDirection::LONG ? "LONG" : desired_signal == SignalDirection::SHORT ? "SHORT" : "FLAT")
@@ -236,7 +236,7 @@ public:
 
         // trade first symbol
         auto const& kv = *ev.data.begin();
-        const std::string sym = kv.first;
+        const SymbolId    sym = kv.first;
         const PriceBar&   bar = kv.second;
 
         history_.push_back(bar);
@@ -1,11 +1,187 @@
 #include "src/data/DataManager.h"
+#include "src/data/BarCache.h"
+#include "src/data/CsvInflater.h"
+#include "src/data/BulkFileReader.h"
+#include "src/data/CsvScanner.h"
 #include "src/strategies/MovingAverageCrossover.h"
 #include "src/strategies/VWAPReversion.h" 
 #include "src/strategies/PairsTrading.h"
 #include "src/core/Backtester.h"
+#include "src/core/Utils.h"
 #include <iostream>
 #include <cassert>
 #include <iomanip>
+#include <limits>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <csv2/mio.hpp>
+#include <set>
+#include <tuple>
+#if __has_include(<zlib.h>)
+#include <zlib.h>
+#endif
+
+namespace fs = std::filesystem;
+
+// --- Shared fixtures ---
+
+const std::string SAMPLE_DATA = "data/stocks_april";
+const std::string CSV_HEADER = "open,high,low,close,volume,date_only,time_only\n";
+
+// Loads the first 1000 rows of every sample file, stored as `storage`.
+bool load_sample(DataManager& dm, DataManager::BarStorage storage = DataManager::BarStorage::Rows) {
+    dm.setMaxRowsToLoad(1000);
+    dm.setBarStorage(storage);
+    if (!dm.loadData(SAMPLE_DATA)) {
+        std::cerr << "FAILED to load " << SAMPLE_DATA << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// One CSV row of a bar trading around `price`.
+std::string csv_row(const std::string& date, const std::string& time, double price, long long volume = 100) {
+    std::ostringstream row;
+    row << price << "," << price + 0.5 << "," << price - 0.5 << "," << price + 0.25 << ","
+        << volume << "," << date << "," << time << "\n";
+    return row.str();
+}
+
+// The timestamp the loader gives a row stamped `date` `time` (UTC).
+std::chrono::system_clock::time_point utc(const std::string& date, const std::string& time) {
+    std::chrono::system_clock::time_point t;
+    TimestampParser().parse(date, time, t);
+    return t;
+}
+
+// Directory for generated data files, removed with its contents afterwards.
+class ScratchDir {
+public:
+    explicit ScratchDir(const std::string& name) : path_(fs::temp_directory_path() / ("trading_system_test_" + name)) {
+        std::error_code ec;
+        fs::remove_all(path_, ec);
+        fs::create_directories(path_);
+    }
+    ~ScratchDir() {
+        std::error_code ec;
+        fs::remove_all(path_, ec);
+    }
+
+    std::string path() const { return path_.string(); }
+    std::string file(const std::string& name) const { return (path_ / name).string(); }
+
+    // Writes `text` to `name`, or appends it with `append`.
+    void write(const std::string& name, const std::string& text, bool append = false) const {
+        std::ofstream out(file(name), std::ios::binary | (append ? std::ios::app : std::ios::trunc));
+        out << text;
+    }
+
+private:
+    fs::path path_;
+};
+
+bool same_bar(const PriceBar& a, const PriceBar& b) {
+    return a.timestamp == b.timestamp && a.Open == b.Open && a.High == b.High && a.Low == b.Low &&
+           a.Close == b.Close && a.Volume == b.Volume;
+}
+
+// Replays `expected` and `actual` (DataManagers, ReplayCursors or MergeCursors)
+// to the end side by side; reports the first tick at which they differ.
+template <typename Expected, typename Actual>
+bool same_replay(Expected& expected, Actual& actual, const std::string& what, size_t& ticks) {
+    DataSnapshot a;
+    DataSnapshot b;
+    for (ticks = 0;; ++ticks) {
+        const bool moreA = expected.getNextBars(a);
+        const bool moreB = actual.getNextBars(b);
+        bool same = moreA == moreB && a.size() == b.size() && (!moreA || expected.getCurrentTime() == actual.getCurrentTime());
+        for (auto ia = a.begin(), ib = b.begin(); same && ia != a.end(); ++ia, ++ib) {
+            same = ia->first == ib->first && same_bar(ia->second, ib->second);
+        }
+        if (!same) {
+            std::cerr << "ERROR: " << what << " diverged at tick " << ticks << std::endl;
+            return false;
+        }
+        if (!moreA) {
+            return true;
+        }
+    }
+}
+
+// Runs `body` and returns what it printed to std::cout and std::cerr.
+template <typename Body>
+std::string capture_output(Body body) {
+    std::ostringstream captured;
+    std::streambuf* out = std::cout.rdbuf(captured.rdbuf());
+    std::streambuf* err = std::cerr.rdbuf(captured.rdbuf());
+    body();
+    std::cout.rdbuf(out);
+    std::cerr.rdbuf(err);
+    return captured.str();
+}
+
+// Every row RowScanner finds in `csv`: its cell count, then its cells, joined by '|'.
+std::vector<std::string> scan_rows(const std::string& csv) {
+    std::vector<std::string> rows;
+    csvparse::RowScanner scanner(csv.data(), 0, csv.size());
+    std::string_view cells[8];
+    size_t count = 0;
+    while (scanner.nextRow(cells, count)) {
+        std::string row = std::to_string(count);
+        for (size_t i = 0; i < std::min<size_t>(count, 8); ++i) {
+            row += "|" + std::string(cells[i]);
+        }
+        rows.push_back(row);
+    }
+    return rows;
+}
+
+void test_csv_scanner() {
+    std::cout << "\n=== Testing CSV Structural Indexers ===" << std::endl;
+
+    // Quoted cells keep their quotes; only their commas and newlines stop being structural.
+    std::vector<std::pair<std::string, std::vector<std::string>>> cases = {
+        {"\"a,b\",c\n\"line1\nline2\",d\n", {"2|\"a,b\"|c", "2|\"line1\nline2\"|d"}},
+        {"\"say \"\"hi\"\"\",x\n\"\"\"\",y\n", {"2|\"say \"\"hi\"\"\"|x", "2|\"\"\"\"|y"}},
+        {"1,2\r\n3,4\r\n", {"2|1|2", "2|3|4"}},
+        {"1,2\n3,4", {"2|1|2", "2|3|4"}},
+    };
+    // Rows of every length up to a few words, with quoted commas, newlines and
+    // escaped quotes at every offset into the 16- and 32-byte lanes, spanning
+    // more than one 64 KiB block.
+    std::string mixed;
+    std::vector<std::string> expectedMixed;
+    for (size_t row = 0; mixed.size() < 3 * csvparse::StructuralBlock::BYTES / 2; ++row) {
+        const std::string name(row % 37, 'x');
+        const std::string quoted = "\"" + std::string(row % 23, 'q') + (row % 2 ? ",\n\"\"" : "\"\"") + "\"";
+        mixed += name + "," + quoted + "," + std::to_string(row) + (row % 3 ? "\n" : "\r\n");
+        expectedMixed.push_back("3|" + name + "|" + quoted + "|" + std::to_string(row));
+    }
+    cases.emplace_back(mixed, expectedMixed);
+
+    const std::string original = csvparse::structuralIndexerName();
+    size_t compared = 0;
+    for (const char* indexer : {"scalar", "sse2", "avx2"}) {
+        if (!csvparse::selectStructuralIndexer(indexer)) {
+            std::cout << indexer << " is not available here; skipped" << std::endl;
+            continue;
+        }
+        for (const auto& [csv, expected] : cases) {
+            if (scan_rows(csv) != expected) {
+                std::cerr << "ERROR: The " << indexer << " indexer split a " << csv.size() << "-byte input into other rows than "
+                          << expected.size() << " expected" << std::endl;
+                csvparse::selectStructuralIndexer(original);
+                return;
+            }
+        }
+        ++compared;
+    }
+    csvparse::selectStructuralIndexer(original);
+    std::cout << compared << " structural indexers split quoted, CRLF and unterminated rows (" << expectedMixed.size()
+              << " across block boundaries) as expected" << std::endl;
+}
 
 void test_data_loading() {
     std::cout << "=== Testing Data Loading ===" << std::endl;
@@ -38,7 +214,8 @@ void test_data_loading() {
             if (!snapshot.empty()) {
                 auto time_t_val = std::chrono::system_clock::to_time_t(dm.getCurrentTime());
                 std::cout << "Bar " << bars_checked << " @ " << std::put_time(std::gmtime(&time_t_val), "%Y-%m-%d %H:%M:%S") << ": ";
-                for (const auto& [symbol, bar] : snapshot) {
+                for (const auto& [symbol_id, bar] : snapshot) {
+                    const std::string& symbol = dm.getSymbolName(symbol_id);
                     std::cout << symbol << "={O:" << bar.Open << ",H:" << bar.High << ",L:" << bar.Low << ",C:" << bar.Close << ",V:" << bar.Volume << "} ";
                     
                     // Validate OHLC logic
@@ -59,6 +236,1032 @@ void test_data_loading() {
     }
 }
 
+void test_parallel_ranges() {
+    std::cout << "\n=== Testing Parallel Range Split ===" << std::endl;
+
+    // A file large enough for three ranges, with a malformed row every few
+    // thousand, so some fall into every range.
+    ScratchDir dir("parallel_ranges");
+    std::string csv = CSV_HEADER;
+    char time[16];
+    for (size_t row = 0; csv.size() < 3 * (size_t(4) << 20) + (1 << 20); ++row) {
+        if (row % 4999 == 17) {
+            csv += "oops,1,1,1,100,2025-04-01,09:30:00\n";
+            continue;
+        }
+        const size_t second = row % 86400;
+        std::snprintf(time, sizeof(time), "%02zu:%02zu:%02zu", second / 3600, second / 60 % 60, second % 60);
+        csv += csv_row("2025-04-0" + std::to_string(1 + row / 86400), time, 100 + double(row % 1000) / 8);
+    }
+    dir.write("BIG.csv", csv);
+
+    // Both caps cut in the second range; the second stops right before a
+    // malformed row, which must then not be reported.
+    for (size_t cap : {std::numeric_limits<size_t>::max(), size_t(100000), size_t(4999 * 20 + 17 - 20)}) {
+        DataManager split;
+        DataManager whole;
+        split.setLoaderThreads(4);
+        whole.setLoaderThreads(1);
+        if (cap != std::numeric_limits<size_t>::max()) {
+            split.setMaxRowsToLoad(cap);
+            whole.setMaxRowsToLoad(cap);
+        }
+        // Keep only the diagnostics: the rest of the output names thread counts.
+        auto diagnostics = [](const std::string& output) {
+            std::istringstream lines(output);
+            std::string kept;
+            for (std::string line; std::getline(lines, line);) {
+                if (line.find("Skipping row") != std::string::npos || line.find("row limit") != std::string::npos) kept += line + "\n";
+            }
+            return kept;
+        };
+        const std::string splitOutput = diagnostics(capture_output([&] { split.loadData(dir.path()); }));
+        const std::string wholeOutput = diagnostics(capture_output([&] { whole.loadData(dir.path()); }));
+        const std::vector<PriceBar>& a = split.getAssetData("BIG")->get();
+        const std::vector<PriceBar>& b = whole.getAssetData("BIG")->get();
+        bool same = a.size() == b.size() && !a.empty();
+        for (size_t i = 0; same && i < a.size(); ++i) {
+            same = same_bar(a[i], b[i]);
+        }
+        const std::string label = cap == std::numeric_limits<size_t>::max() ? "uncapped" : "capped at " + std::to_string(cap);
+        if (!same || splitOutput != wholeOutput || splitOutput.find("Skipping row 19") == std::string::npos) {
+            std::cerr << "ERROR: A parse split into ranges (" << label << ") should match a single-range one: "
+                      << a.size() << " vs " << b.size() << " bars, diagnostics\n" << splitOutput << "vs\n" << wholeOutput;
+            return;
+        }
+        std::cout << "Split parse " << label << ": " << a.size() << " bars and "
+                  << std::count(splitOutput.begin(), splitOutput.end(), '\n') << " diagnostics match a single range" << std::endl;
+    }
+}
+
+void test_columnar_storage() {
+    std::cout << "\n=== Testing Columnar Bar Storage ===" << std::endl;
+
+    DataManager rows;
+    DataManager columns;
+    DataManager both;
+    if (!load_sample(rows) || !load_sample(columns, DataManager::BarStorage::Columns) ||
+        !load_sample(both, DataManager::BarStorage::RowsAndColumns)) {
+        return;
+    }
+
+    for (const auto& symbol : rows.getAllSymbols()) {
+        const auto& bars = rows.getAssetData(symbol)->get();
+        auto closes = columns.getPriceSpan(symbol, DataManager::PriceField::Close);
+        auto times = columns.getTimestampSpan(symbol);
+        bool match = closes.size() == bars.size() && times.size() == bars.size();
+        for (size_t i = 0; match && i < bars.size(); ++i) {
+            match = closes[i] == bars[i].Close && times[i] == bars[i].timestamp;
+        }
+        if (!match) {
+            std::cerr << "ERROR: Column spans differ from row storage for " << symbol << std::endl;
+        } else {
+            std::cout << symbol << ": " << closes.size() << " closes match row storage" << std::endl;
+        }
+        if (columns.getAssetData(symbol)) {
+            std::cerr << "ERROR: Columns-only storage should not expose row data for " << symbol << std::endl;
+        }
+
+        // RowsAndColumns keeps both layouts of the same bars.
+        const auto bothRows = both.getAssetData(symbol);
+        const auto bothColumns = both.getAssetColumns(symbol);
+        match = bothRows && bothColumns && bothRows->get().size() == bars.size() && bothColumns->get().size() == bars.size();
+        for (size_t i = 0; match && i < bars.size(); ++i) {
+            match = same_bar(bothRows->get()[i], bars[i]) && same_bar(bothColumns->get().bar(i), bars[i]);
+        }
+        if (!match) {
+            std::cerr << "ERROR: RowsAndColumns storage does not hold both layouts of " << symbol << std::endl;
+        }
+    }
+    if (columns.getPriceSpan("NO_SUCH_SYMBOL", DataManager::PriceField::Close).size() != 0 ||
+        columns.getVolumeSpan("NO_SUCH_SYMBOL").size() != 0) {
+        std::cerr << "ERROR: Spans of a symbol that is not loaded should be empty" << std::endl;
+    }
+
+    // Replay must produce the same snapshots from either layout
+    size_t ticks = 0;
+    if (same_replay(rows, columns, "Columnar replay", ticks)) {
+        std::cout << "Replayed " << ticks << " identical ticks from row and column storage" << std::endl;
+    }
+}
+
+void test_bar_cache() {
+    std::cout << "\n=== Testing Bar Cache ===" << std::endl;
+
+    ScratchDir dir("bar_cache");
+    std::string csv = CSV_HEADER;
+    for (int minute = 0; minute < 30; ++minute) {
+        csv += csv_row("2025-04-01", std::string("10:") + (minute < 10 ? "0" : "") + std::to_string(minute) + ":00",
+                       100 + minute, 10 + minute);
+    }
+    csv += "1,2,3\n"; // Diagnosed on the first parse and replayed on every cache hit
+    dir.write("CACHED.csv", csv);
+    const std::string cacheDir = dir.file("cache");
+    const std::string cachePath = BarCache::cachePathFor(cacheDir, dir.file("CACHED.csv"));
+
+    // Loads the directory through the cache; `fromCache` tells whether the bars were mapped back.
+    // Either way the skipped row must be reported.
+    auto load = [&](bool& fromCache, std::vector<PriceBar>& bars) {
+        DataManager dm;
+        dm.setBarCacheDir(cacheDir);
+        bool loaded = false;
+        const std::string output = capture_output([&] { loaded = dm.loadData(dir.path()); });
+        fromCache = output.find("from bar cache") != std::string::npos;
+        bars = loaded ? dm.getAssetData("CACHED")->get() : std::vector<PriceBar>();
+        return loaded && output.find("Skipping row 32 in CACHED.csv") != std::string::npos;
+    };
+    auto sameBars = [](const std::vector<PriceBar>& a, const std::vector<PriceBar>& b) {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), same_bar);
+    };
+
+    std::vector<PriceBar> parsed;
+    std::vector<PriceBar> bars;
+    bool fromCache = false;
+    if (!load(fromCache, parsed) || fromCache || parsed.size() != 30 || !fs::exists(cachePath)) {
+        std::cerr << "ERROR: The first load should parse the CSV and write " << cachePath << std::endl;
+        return;
+    }
+    if (!load(fromCache, bars) || !fromCache || !sameBars(bars, parsed)) {
+        std::cerr << "ERROR: An unchanged file should be served from the bar cache with the parsed bars" << std::endl;
+        return;
+    }
+
+    // Same bytes, other mtime: stale.
+    fs::last_write_time(dir.file("CACHED.csv"), fs::last_write_time(dir.file("CACHED.csv")) - std::chrono::hours(1));
+    if (!load(fromCache, bars) || fromCache || !sameBars(bars, parsed)) {
+        std::cerr << "ERROR: A cache entry should be stale once the source mtime changes" << std::endl;
+        return;
+    }
+
+    // Appended row: stale by size, and the new bar is loaded.
+    dir.write("CACHED.csv", csv_row("2025-04-01", "10:30:00", 130, 40), true);
+    if (!load(fromCache, bars) || fromCache || bars.size() != 31 ||
+        bars.back().timestamp != utc("2025-04-01", "10:30:00")) {
+        std::cerr << "ERROR: A cache entry should be stale once the source size changes" << std::endl;
+        return;
+    }
+    parsed = bars;
+    if (!load(fromCache, bars) || !fromCache || !sameBars(bars, parsed)) {
+        std::cerr << "ERROR: The reparse should have rewritten the bar cache" << std::endl;
+        return;
+    }
+
+    // A truncated cache file and one with a damaged header are misses, not bad data.
+    for (const char* damage : {"truncated", "bad magic"}) {
+        std::string bytes;
+        {
+            std::ifstream in(cachePath, std::ios::binary);
+            bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        if (std::string(damage) == "truncated") {
+            bytes.resize(bytes.size() / 2);
+        } else {
+            bytes[0] = static_cast<char>(~bytes[0]);
+        }
+        std::ofstream(cachePath, std::ios::binary | std::ios::trunc) << bytes;
+        if (!load(fromCache, bars) || fromCache || !sameBars(bars, parsed)) {
+            std::cerr << "ERROR: A " << damage << " cache file should be ignored and the CSV parsed" << std::endl;
+            return;
+        }
+    }
+    std::cout << "Bar cache hits, goes stale on mtime and size changes and ignores corrupt files" << std::endl;
+}
+
+void test_time_window() {
+    std::cout << "\n=== Testing Time-Window Loads ===" << std::endl;
+
+    // 3000 one-second bars from 10:00:00, so the time index has entries at bars 0, 1024 and 2048,
+    // and a malformed row right after bar 1100.
+    ScratchDir dir("time_window");
+    auto timeOf = [](int second) {
+        std::ostringstream text;
+        text << std::setfill('0') << std::setw(2) << 10 + second / 3600 << ":" << std::setw(2) << second / 60 % 60
+             << ":" << std::setw(2) << second % 60;
+        return text.str();
+    };
+    std::string csv = CSV_HEADER;
+    for (int second = 0; second < 3000; ++second) {
+        csv += csv_row("2025-04-01", timeOf(second), 100 + second % 50);
+        if (second == 1100) csv += "bad,row\n";
+    }
+    dir.write("WIN.csv", csv);
+    const std::string badRow = "Skipping row 1103 in WIN.csv";
+
+    // Loads [start, end) of the directory into `dm`; the diagnostics must report the bad row.
+    auto load = [&](DataManager& dm, int start, int end, std::vector<PriceBar>& bars, std::string& output) {
+        bool loaded = false;
+        output = capture_output([&] {
+            loaded = dm.loadData(dir.path(), utc("2025-04-01", timeOf(start)), utc("2025-04-01", timeOf(end)));
+        });
+        bars = loaded ? dm.getAssetData("WIN")->get() : std::vector<PriceBar>();
+        return loaded && output.find(badRow) != std::string::npos;
+    };
+    // Exactly the bars start..end-1: the start bound is inclusive, the end bound exclusive.
+    auto windowOk = [&](const std::vector<PriceBar>& bars, int start, int end) {
+        bool ok = bars.size() == static_cast<size_t>(end - start);
+        for (size_t i = 0; ok && i < bars.size(); ++i) {
+            ok = bars[i].timestamp == utc("2025-04-01", timeOf(start + static_cast<int>(i)));
+        }
+        return ok;
+    };
+
+    const std::vector<std::pair<int, int>> windows = {{1024, 2048}, {1100, 1102}, {1023, 1025}};
+    DataManager indexed;
+    DataManager cached;
+    cached.setBarCacheDir(dir.file("cache"));
+    std::vector<PriceBar> bars;
+    std::string output;
+    capture_output([&] { cached.loadData(dir.path()); }); // Writes the bar cache
+    for (size_t w = 0; w < windows.size(); ++w) {
+        const auto [start, end] = windows[w];
+        // The first load of `indexed` parses the whole file and indexes it; later ones seek.
+        const bool seeks = w > 0;
+        if (!load(indexed, start, end, bars, output) || !windowOk(bars, start, end) ||
+            seeks != (output.find("via its time index") != std::string::npos)) {
+            std::cerr << "ERROR: Window [" << start << ", " << end << ") " << (seeks ? "seeked" : "parsed")
+                      << " through the time index is wrong" << std::endl;
+            return;
+        }
+        if (!load(cached, start, end, bars, output) || !windowOk(bars, start, end) ||
+            output.find("window from bar cache") == std::string::npos) {
+            std::cerr << "ERROR: Window [" << start << ", " << end << ") read from the bar cache is wrong" << std::endl;
+            return;
+        }
+    }
+    std::cout << "Windows on and between index entries load the same bars and diagnostics from the CSV, "
+              << "its time index and the bar cache" << std::endl;
+}
+
+void test_compressed_input() {
+    std::cout << "\n=== Testing Compressed Input ===" << std::endl;
+#if __has_include(<zlib.h>)
+    if (!CsvInflater::available(CsvInflater::Codec::Gzip)) {
+        std::cout << "Skipped: this build has no gzip support" << std::endl;
+        return;
+    }
+    std::string csv = CSV_HEADER;
+    for (int minute = 30; minute < 60; ++minute) {
+        csv += csv_row("2025-04-01", "09:" + std::to_string(minute) + ":00", 50 + minute, minute);
+    }
+    ScratchDir plain("compressed_input_plain");
+    plain.write("GZP.csv", csv);
+    ScratchDir packed("compressed_input_gz");
+    gzFile out = gzopen(packed.file("GZP.csv.gz").c_str(), "wb");
+    gzwrite(out, csv.data(), static_cast<unsigned>(csv.size()));
+    gzclose(out);
+
+    DataManager expected;
+    DataManager dm;
+    capture_output([&] { expected.loadData(plain.path()); });
+    capture_output([&] { dm.loadData(packed.path()); });
+    const auto& want = expected.getAssetData("GZP")->get();
+    const auto bars = dm.getAssetData("GZP");
+    if (want.size() != 30 || !bars || !std::equal(want.begin(), want.end(), bars->get().begin(), bars->get().end(), same_bar)) {
+        std::cerr << "ERROR: A .csv.gz file should load the same bars as the plain CSV" << std::endl;
+        return;
+    }
+
+    // With both files present the symbol is loaded once, from the plain file.
+    packed.write("GZP.csv", csv);
+    std::string output = capture_output([&] { dm.loadData(packed.path()); });
+    if (dm.getAllSymbols() != std::vector<std::string>{"GZP"} || dm.getAssetData("GZP")->get().size() != 30 ||
+        output.find("Parsing file: GZP.csv for") == std::string::npos ||
+        output.find("GZP.csv and GZP.csv.gz both hold symbol GZP") == std::string::npos) {
+        std::cerr << "ERROR: A symbol with a plain and a gzip file should load only the plain one" << std::endl;
+        return;
+    }
+    std::cout << "Gzip input matches the plain CSV and is skipped next to it" << std::endl;
+#else
+    std::cout << "Skipped: zlib headers not found" << std::endl;
+#endif
+}
+
+void test_bulk_file_reader() {
+    std::cout << "\n=== Testing Bulk File Reader ===" << std::endl;
+
+    // A small file, an empty one, one larger than the 1 MiB arena and one that does not exist.
+    ScratchDir dir("bulk_reader");
+    std::string large = CSV_HEADER;
+    while (large.size() < (size_t(3) << 20)) {
+        large += csv_row("2025-04-01", "09:30:00", 100 + large.size() % 97);
+    }
+    dir.write("SMALL.csv", CSV_HEADER + csv_row("2025-04-01", "09:30:00", 10));
+    dir.write("EMPTY.csv", "");
+    dir.write("LARGE.csv", large);
+    const std::vector<std::string> paths{dir.file("SMALL.csv"), dir.file("EMPTY.csv"), dir.file("LARGE.csv"),
+                                         dir.file("MISSING.csv")};
+    const bool available = BulkFileReader::available();
+    std::vector<bool> seen(paths.size(), false);
+    {
+        BulkFileReader reader(paths, size_t(1) << 20);
+        BulkFileReader::File file;
+        while (reader.next(file)) {
+            const std::string& path = paths[file.index];
+            seen[file.index] = true;
+            bool same = false;
+            if (!available || file.index == 3) {
+                // Without io_uring every file is an error, for the caller to map instead.
+                same = !file.error.empty() && file.data == nullptr;
+            } else if (file.index == 1) {
+                same = file.error.empty() && file.size == 0;
+            } else {
+                mio::mmap_source mapped(path);
+                same = file.error.empty() && file.size == mapped.size() &&
+                       std::memcmp(file.data, mapped.data(), mapped.size()) == 0;
+            }
+            reader.release(file);
+            if (!same) {
+                std::cerr << "ERROR: BulkFileReader read " << path << " differently from an mmap of it" << std::endl;
+                return;
+            }
+        }
+    }
+    if (std::find(seen.begin(), seen.end(), false) != seen.end()) {
+        std::cerr << "ERROR: BulkFileReader should hand out every file once" << std::endl;
+        return;
+    }
+
+    // Loads through io_uring replay like an mmap load, whether every file is
+    // read by the ring, only those without a bar cache entry, or (where
+    // io_uring is unavailable) none.
+    ScratchDir data("bulk_reader_load");
+    for (const std::string symbol : {"AAA", "BBB", "CCC"}) {
+        std::string csv = CSV_HEADER;
+        for (int second = 0; second < 500; ++second) {
+            csv += csv_row("2025-04-01", "09:3" + std::to_string(second / 60) + ":" + (second % 60 < 10 ? "0" : "") +
+                                             std::to_string(second % 60), symbol[0] + second % 13);
+        }
+        data.write(symbol + ".csv", csv);
+    }
+    DataManager expected;
+    capture_output([&] { expected.loadData(data.path()); });
+    DataManager uring;
+    uring.setFileReader(DataManager::FileReader::IoUring);
+    uring.setBarCacheDir(dir.file("cache"));
+    for (const char* reads : {"Reading 3 files with io_uring", "Reading 1 files with io_uring"}) {
+        const std::string output = capture_output([&] { uring.loadData(data.path()); });
+        const bool fellBack = output.find("io_uring is not available here") != std::string::npos;
+        if (available ? output.find(reads) == std::string::npos : !fellBack) {
+            std::cerr << "ERROR: An io_uring load should read the uncached files with io_uring, or all with mmap without it" << std::endl;
+            return;
+        }
+        DataManager replayed(expected);
+        size_t ticks = 0;
+        if (!same_replay(replayed, uring, std::string("io_uring load (") + reads + ")", ticks)) {
+            return;
+        }
+        // The next load finds AAA and CCC in the bar cache.
+        fs::remove(BarCache::cachePathFor(dir.file("cache"), data.file("BBB.csv")));
+    }
+    std::cout << (available ? "io_uring" : "mmap fallback") << " reads match mmap byte for byte, and loads through it replay alike"
+              << std::endl;
+}
+
+void test_page_hints() {
+    std::cout << "\n=== Testing Page Hints ===" << std::endl;
+
+    // Every hint, including huge pages on the bar arrays of each storage, leaves the bars as they are.
+    PageHints hints;
+    hints.sequential = true;
+    hints.willNeed = true;
+    hints.hugePages = true;
+    const std::pair<DataManager::BarStorage, const char*> storages[] = {
+        {DataManager::BarStorage::Rows, "Rows"}, {DataManager::BarStorage::RowsAndColumns, "RowsAndColumns"},
+        {DataManager::BarStorage::Compressed, "Compressed"}, {DataManager::BarStorage::Ticks, "Ticks"}};
+    for (const auto& [storage, name] : storages) {
+        DataManager plain;
+        DataManager hinted;
+        plain.setBarStorage(storage);
+        hinted.setBarStorage(storage);
+        hinted.setPageHints(hints);
+        capture_output([&] { plain.loadData(SAMPLE_DATA); });
+        capture_output([&] { hinted.loadData(SAMPLE_DATA); });
+        const PageFaults plainFaults = plain.getLoadPageFaults();
+        const PageFaults hintedFaults = hinted.getLoadPageFaults();
+#if defined(__linux__)
+        const bool counted = plainFaults.minor > 0 && hintedFaults.minor > 0;
+#else
+        const bool counted = plainFaults.minor == 0 && hintedFaults.minor == 0;
+#endif
+        if (!counted || plainFaults.major < 0 || hintedFaults.major < 0) {
+            std::cerr << "ERROR: getLoadPageFaults should count the page faults of the last load" << std::endl;
+            return;
+        }
+        size_t ticks = 0;
+        if (!same_replay(plain, hinted, "Load with page hints", ticks)) {
+            return;
+        }
+        std::cout << name << ": " << ticks << " ticks replayed alike; minor page faults "
+                  << plainFaults.minor << " plain, " << hintedFaults.minor << " with every hint" << std::endl;
+    }
+}
+
+void test_symbol_loads() {
+    std::cout << "\n=== Testing Symbol Loads ===" << std::endl;
+
+    ScratchDir dir("symbol_loads");
+    for (const std::string symbol : {"AAA", "BBB", "CCC"}) {
+        std::string csv = CSV_HEADER;
+        for (int minute = 30; minute < 40; ++minute) {
+            csv += csv_row("2025-04-01", "09:" + std::to_string(minute) + ":00", symbol[0] + minute);
+        }
+        dir.write(symbol + ".csv", csv);
+    }
+    DataManager full;
+    capture_output([&] { full.loadData(dir.path()); });
+
+    DataManager dm;
+    std::string output = capture_output([&] { dm.loadData(dir.path(), {"AAA", "BBB", "ZZZ"}); });
+    if (dm.getAllSymbols() != std::vector<std::string>{"AAA", "BBB"} || dm.getTimeline().size() != 10 ||
+        output.find("No data file for symbol ZZZ") == std::string::npos) {
+        std::cerr << "ERROR: A symbol load should load just the files of the symbols asked for" << std::endl;
+        return;
+    }
+    const std::vector<PriceBar>* bbb = &dm.getAssetData("BBB")->get();
+
+    // BBB is unchanged, so the next load shares its bars instead of parsing or copying them.
+    output = capture_output([&] { dm.loadData(dir.path(), {"BBB", "CCC"}); });
+    if (dm.getAllSymbols() != std::vector<std::string>{"BBB", "CCC"} || &dm.getAssetData("BBB")->get() != bbb ||
+        output.find("Reusing parsed file: BBB.csv") == std::string::npos ||
+        output.find("Parsing file: CCC.csv") == std::string::npos) {
+        std::cerr << "ERROR: An unchanged file should be reused without copying its bars" << std::endl;
+        return;
+    }
+    // Appending to the reused series copies it; the kept one stays as parsed.
+    dir.write("BBB.csv", csv_row("2025-04-01", "09:40:00", 200), true);
+    capture_output([&] { dm.refreshData(); });
+    if (dm.getAssetData("BBB")->get().size() != 11 || bbb->size() != 10) {
+        std::cerr << "ERROR: refreshData should not change the series kept for symbol loads" << std::endl;
+        return;
+    }
+    output = capture_output([&] { dm.loadData(dir.path(), {"BBB"}); });
+    if (output.find("Parsing file: BBB.csv") == std::string::npos || dm.getAssetData("BBB")->get().size() != 11) {
+        std::cerr << "ERROR: A file that changed on disk should be parsed again" << std::endl;
+        return;
+    }
+
+    // Reuse follows the bar storage: shared in the same layout, converted to another one.
+    DataManager packed;
+    packed.setBarStorage(DataManager::BarStorage::Compressed);
+    capture_output([&] { packed.loadData(dir.path(), {"AAA"}); });
+    const CompressedBars* aaa = &packed.getCompressedBars("AAA")->get();
+    output = capture_output([&] { packed.loadData(dir.path(), {"AAA"}); });
+    if (output.find("Reusing parsed file: AAA.csv") == std::string::npos || &packed.getCompressedBars("AAA")->get() != aaa) {
+        std::cerr << "ERROR: Compressed bars should be reused as they are" << std::endl;
+        return;
+    }
+    packed.setBarStorage(DataManager::BarStorage::Rows);
+    output = capture_output([&] { packed.loadData(dir.path(), {"AAA"}); });
+    const auto& expected = full.getAssetData("AAA")->get();
+    const auto rows = packed.getAssetData("AAA");
+    if (output.find("Reusing parsed file: AAA.csv") == std::string::npos || packed.getCompressedBars("AAA") || !rows ||
+        !std::equal(expected.begin(), expected.end(), rows->get().begin(), rows->get().end(), same_bar)) {
+        std::cerr << "ERROR: A file reused in another bar storage should be converted to it" << std::endl;
+        return;
+    }
+    std::cout << "Symbol loads parse only the subscribed files and share unchanged ones across loads" << std::endl;
+}
+
+void test_compressed_storage() {
+    std::cout << "\n=== Testing Compressed Bar Storage ===" << std::endl;
+
+    DataManager rows;
+    DataManager compressed;
+    if (!load_sample(rows) || !load_sample(compressed, DataManager::BarStorage::Compressed)) {
+        return;
+    }
+
+    for (const auto& symbol : rows.getAllSymbols()) {
+        const auto& bars = rows.getAssetData(symbol)->get();
+        const CompressedBars& packed = compressed.getCompressedBars(symbol)->get();
+        bool match = packed.size() == bars.size();
+        size_t i = 0;
+        for (auto it = packed.begin(); match && it != packed.end(); ++it, ++i) {
+            match = same_bar(*it, bars[i]);
+        }
+        if (!match) {
+            std::cerr << "ERROR: Compressed bars differ from row storage for " << symbol << " at bar " << i << std::endl;
+        } else {
+            std::cout << symbol << ": " << packed.size() << " bars decode exactly, "
+                      << packed.memoryBytes() << " bytes vs " << bars.size() * sizeof(PriceBar) << std::endl;
+        }
+    }
+
+    size_t ticks = 0;
+    if (same_replay(rows, compressed, "Compressed replay", ticks)) {
+        std::cout << "Replayed " << ticks << " identical ticks from row and compressed storage" << std::endl;
+    }
+}
+
+void test_compressed_price_modes() {
+    std::cout << "\n=== Testing Compressed Price Modes ===" << std::endl;
+
+    // Block 0 holds exact decimals, block 1 thirds (XOR fallback, plus an infinity),
+    // block 2 decimals and one -0.0, and a short tail block after it.
+    const size_t block = CompressedBars::BLOCK_BARS;
+    std::vector<PriceBar> rows(3 * block + 10);
+    for (size_t i = 0; i < rows.size(); ++i) {
+        PriceBar& bar = rows[i];
+        bar.timestamp = utc("2025-04-01", "09:30:00") + std::chrono::seconds(i + (i % 7 == 0 ? 3 : 0));
+        const double base = i / block == 1 ? 100.0 + i / 3.0 : 100.0 + (i % 100) * 0.01;
+        bar.Open = base;
+        bar.High = base + 0.5;
+        bar.Low = base - 0.5;
+        bar.Close = base + 0.25;
+        bar.Volume = static_cast<long long>(i * 37 % 1000);
+    }
+    rows[block + 5].High = std::numeric_limits<double>::infinity();
+    rows[2 * block + 9].Low = -0.0;
+
+    const CompressedBars packed = CompressedBars::fromRows(rows);
+    auto sameBits = [](double a, double b) { return std::memcmp(&a, &b, sizeof(a)) == 0; };
+    bool match = packed.size() == rows.size() && packed.blockCount() == 4;
+    size_t i = 0;
+    for (auto it = packed.begin(); match && it != packed.end(); ++it, ++i) {
+        match = it->timestamp == rows[i].timestamp && sameBits(it->Open, rows[i].Open) &&
+                sameBits(it->High, rows[i].High) && sameBits(it->Low, rows[i].Low) &&
+                sameBits(it->Close, rows[i].Close) && it->Volume == rows[i].Volume;
+    }
+    if (!match) {
+        std::cerr << "ERROR: Compressed bars do not decode bit for bit at bar " << (i > 0 ? i - 1 : 0) << std::endl;
+        return;
+    }
+    std::cout << packed.size() << " bars in decimal, XOR and -0.0 blocks decode bit for bit" << std::endl;
+}
+
+void test_tick_storage() {
+    std::cout << "\n=== Testing Tick Price Storage ===" << std::endl;
+
+    DataManager rows;
+    DataManager ticks;
+    if (!load_sample(rows) || !load_sample(ticks, DataManager::BarStorage::Ticks)) {
+        return;
+    }
+
+    for (const auto& symbol : rows.getAllSymbols()) {
+        const auto& bars = rows.getAssetData(symbol)->get();
+        const TickColumns& columns = ticks.getTickColumns(symbol)->get();
+        bool match = columns.size() == bars.size() && columns.rounded_prices == 0;
+        size_t i = 0;
+        for (; match && i < bars.size(); ++i) {
+            const PriceBar bar = columns.bar(i);
+            match = bar.Open == bars[i].Open && bar.High == bars[i].High && bar.Low == bars[i].Low &&
+                    bar.Close == bars[i].Close && columns.high[i] >= columns.low[i];
+        }
+        if (!match) {
+            std::cerr << "ERROR: Tick prices differ from row storage for " << symbol << " at bar " << i << std::endl;
+        } else {
+            std::cout << symbol << ": " << columns.size() << " bars round-trip exactly at tick " << columns.tick.size()
+                      << std::endl;
+        }
+    }
+}
+
+void test_tick_size_inference() {
+    std::cout << "\n=== Testing Tick Size Inference ===" << std::endl;
+
+    ScratchDir dir("tick_size");
+    dir.write("CENTS.csv", CSV_HEADER + csv_row("2025-04-01", "09:30:00", 100.01) + csv_row("2025-04-01", "09:31:00", 100.02));
+    dir.write("FINE.csv", CSV_HEADER + "100.123456789,101,99,100.5,10,2025-04-01,09:30:00\n");
+    DataManager dm;
+    dm.setBarStorage(DataManager::BarStorage::Ticks);
+    bool loaded = false;
+    const std::string output = capture_output([&] { loaded = dm.loadData(dir.path()); });
+    if (!loaded || dm.getTickColumns("CENTS")->get().tick.size() != 0.01 ||
+        dm.getTickColumns("CENTS")->get().rounded_prices != 0) {
+        std::cerr << "ERROR: Prices in cents should be stored in ticks of 0.01" << std::endl;
+        return;
+    }
+    // No decimal tick fits 9 digits: the fallback tick is reported, not silent.
+    const TickColumns& fine = dm.getTickColumns("FINE")->get();
+    if (fine.tick.size() != TickSize::decimal(TickSize::MAX_DIGITS).size() || fine.rounded_prices != 1 ||
+        output.find("No decimal tick of up to 8 digits fits every price of FINE") == std::string::npos ||
+        output.find("No decimal tick of up to 8 digits fits every price of CENTS") != std::string::npos) {
+        std::cerr << "ERROR: Falling back to the finest tick should warn once, for FINE only" << std::endl;
+        return;
+    }
+    std::cout << "Inferred 0.01 for cent prices and warned about the 1e-08 fallback" << std::endl;
+}
+
+void test_resampling() {
+    std::cout << "\n=== Testing Timeframe Resampling ===" << std::endl;
+
+    DataManager dm;
+    if (!load_sample(dm)) {
+        return;
+    }
+
+    const Timeframe fiveMinutes = Timeframe::minutes(5);
+    for (const auto& symbol : dm.getAllSymbols()) {
+        const auto& bars = dm.getAssetData(symbol)->get();
+        const ResampledSeries& resampled = dm.getResampledBars(symbol, fiveMinutes)->get();
+
+        // Aggregate by hand: every completed bucket is one 5m bar.
+        std::vector<PriceBar> expected;
+        for (const auto& bar : bars) {
+            const auto start = fiveMinutes.bucketStart(bar.timestamp);
+            if (expected.empty() || expected.back().timestamp != start) {
+                expected.push_back(bar);
+                expected.back().timestamp = start;
+            } else {
+                PriceBar& agg = expected.back();
+                agg.High = std::max(agg.High, bar.High);
+                agg.Low = std::min(agg.Low, bar.Low);
+                agg.Close = bar.Close;
+                agg.Volume += bar.Volume;
+            }
+        }
+        bool match = !expected.empty() && resampled.bars.size() == expected.size() - 1 && resampled.partial() &&
+                     resampled.partial()->Close == expected.back().Close;
+        for (size_t i = 0; match && i < resampled.bars.size(); ++i) {
+            const PriceBar& a = resampled.bars[i];
+            const PriceBar& b = expected[i];
+            match = a.timestamp == b.timestamp && a.Open == b.Open && a.High == b.High && a.Low == b.Low &&
+                    a.Close == b.Close && a.Volume == b.Volume &&
+                    std::chrono::duration_cast<std::chrono::seconds>(a.timestamp.time_since_epoch()).count() % 300 == 0;
+        }
+        if (!match) {
+            std::cerr << "ERROR: 5m bars of " << symbol << " differ from a direct aggregation" << std::endl;
+        } else {
+            std::cout << symbol << ": " << bars.size() << " bars -> " << resampled.bars.size()
+                      << " completed " << fiveMinutes.label() << " bars" << std::endl;
+        }
+    }
+}
+
+void test_resampled_load() {
+    std::cout << "\n=== Testing Resampled Loads ===" << std::endl;
+
+    DataManager dm;
+    if (!load_sample(dm)) {
+        return;
+    }
+    const Timeframe fiveMinutes = Timeframe::minutes(5);
+    DataManager coarse;
+    bool loaded = false;
+    capture_output([&] { loaded = coarse.loadResampled(dm, fiveMinutes); });
+    if (!loaded || coarse.getAllSymbols() != dm.getAllSymbols()) {
+        std::cerr << "ERROR: A resampled load should hold every symbol of its source" << std::endl;
+        return;
+    }
+
+    // Each symbol is its completed buckets plus the one still open; the timeline is their union.
+    std::set<std::chrono::system_clock::time_point> buckets;
+    for (const auto& symbol : dm.getAllSymbols()) {
+        const ResampledSeries& resampled = dm.getResampledBars(symbol, fiveMinutes)->get();
+        std::vector<PriceBar> expected(resampled.bars.begin(), resampled.bars.end());
+        if (resampled.partial()) {
+            expected.push_back(*resampled.partial());
+        }
+        const auto& bars = coarse.getAssetData(symbol)->get();
+        if (!std::equal(expected.begin(), expected.end(), bars.begin(), bars.end(), same_bar)) {
+            std::cerr << "ERROR: Resampled bars of " << symbol << " differ from getResampledBars" << std::endl;
+            return;
+        }
+        for (const auto& bar : bars) buckets.insert(bar.timestamp);
+    }
+    DataSnapshot snapshot;
+    size_t ticks = 0;
+    while (coarse.getNextBars(snapshot)) ++ticks;
+    if (coarse.getTimeline().size() != buckets.size() || ticks != buckets.size()) {
+        std::cerr << "ERROR: A resampled load should replay one tick per 5m bucket" << std::endl;
+        return;
+    }
+    std::cout << "Resampled load replays " << ticks << " 5m buckets of " << dm.getAllSymbols().size() << " symbols" << std::endl;
+}
+
+void test_screening_stats() {
+    std::cout << "\n=== Testing Screening Statistics ===" << std::endl;
+
+    const std::vector<double> returns{1.5, -2.0, 0.5, 3.0};
+    if (rank_correlation(returns, {10, -1, 5, 12}) != 1.0 || rank_correlation(returns, {-10, 1, -5, -12}) != -1.0 ||
+        std::abs(rank_correlation({1, 2, 3, 4}, {1, 3, 3, 4}) - std::sqrt(0.9)) > 1e-12 ||
+        !std::isnan(rank_correlation({1}, {1})) || !std::isnan(rank_correlation({1, 2}, {5, 5}))) {
+        std::cerr << "ERROR: rank_correlation should be Spearman's rho with average ranks for ties" << std::endl;
+        return;
+    }
+
+    const std::vector<size_t> sample = random_sample_indices(100, 10, 42);
+    bool distinct = sample.size() == 10 && sample.back() < 100;
+    for (size_t i = 1; distinct && i < sample.size(); ++i) distinct = sample[i - 1] < sample[i];
+    if (!distinct || random_sample_indices(100, 10, 42) != sample || random_sample_indices(3, 10, 42) != std::vector<size_t>{0, 1, 2}) {
+        std::cerr << "ERROR: random_sample_indices should draw distinct, sorted, reproducible indices" << std::endl;
+        return;
+    }
+    std::cout << "Rank correlation and the screening sample behave as expected" << std::endl;
+}
+
+void test_resampling_bucket_edges() {
+    std::cout << "\n=== Testing Resampling Bucket Edges ===" << std::endl;
+
+    // Bars on both sides of the 09:35 and 09:40 boundaries; the 09:40 bucket is still open.
+    ScratchDir dir("bucket_edges");
+    dir.write("EDGE.csv", CSV_HEADER + csv_row("2025-04-01", "09:30:00", 10, 1) + csv_row("2025-04-01", "09:34:59", 11, 2) +
+                              csv_row("2025-04-01", "09:35:00", 12, 4) + csv_row("2025-04-01", "09:39:59", 13, 8) +
+                              csv_row("2025-04-01", "09:40:00", 14, 16));
+    DataManager dm;
+    if (!dm.loadData(dir.path())) {
+        std::cerr << "ERROR: Could not load " << dir.path() << std::endl;
+        return;
+    }
+
+    const Timeframe fiveMinutes = Timeframe::minutes(5);
+    auto check = [](const PriceBar& bar, const std::string& start, double open, double close, long long volume) {
+        return bar.timestamp == utc("2025-04-01", start) && bar.Open == open && bar.Close == close + 0.25 &&
+               bar.High == close + 0.5 && bar.Low == open - 0.5 && bar.Volume == volume;
+    };
+    const ResampledSeries& resampled = dm.getResampledBars("EDGE", fiveMinutes)->get();
+    if (resampled.bars.size() != 2 || !check(resampled.bars[0], "09:30:00", 10, 11, 3) ||
+        !check(resampled.bars[1], "09:35:00", 12, 13, 12)) {
+        std::cerr << "ERROR: A bar on a bucket boundary was not the first bar of its bucket" << std::endl;
+        return;
+    }
+    if (!resampled.partial() || !check(*resampled.partial(), "09:40:00", 14, 14, 16)) {
+        std::cerr << "ERROR: The open 09:40 bucket should be the partial bar" << std::endl;
+        return;
+    }
+
+    // Appended bars complete the open bucket and start the next one.
+    dir.write("EDGE.csv", csv_row("2025-04-01", "09:44:59", 15, 32) + csv_row("2025-04-01", "09:45:00", 16, 64), true);
+    if (dm.refreshData() != 2) {
+        std::cerr << "ERROR: refreshData should have appended 2 bars" << std::endl;
+        return;
+    }
+    const ResampledSeries& extended = dm.getResampledBars("EDGE", fiveMinutes)->get();
+    if (extended.consumed != 7 || extended.bars.size() != 3 || !check(extended.bars[2], "09:40:00", 14, 15, 48) ||
+        !extended.partial() || !check(*extended.partial(), "09:45:00", 16, 16, 64)) {
+        std::cerr << "ERROR: Appended bars were not folded into the open bucket" << std::endl;
+        return;
+    }
+    std::cout << "Bucket boundaries, the open last bucket and appended bars resample as expected" << std::endl;
+}
+
+void test_tail_follow() {
+    std::cout << "\n=== Testing Tail Follow ===" << std::endl;
+
+    // The last row is still being written when the file is loaded, and is completed in two writes.
+    ScratchDir dir("tail_follow");
+    const std::string last = csv_row("2025-04-01", "09:32:00", 12, 300);
+    const size_t cut = last.size() - 5; // Up to "09:3"
+    dir.write("TAIL.csv", CSV_HEADER + csv_row("2025-04-01", "09:30:00", 10) + csv_row("2025-04-01", "09:31:00", 11) +
+                              last.substr(0, cut));
+    DataManager dm;
+    std::string output = capture_output([&] { dm.loadData(dir.path()); });
+    if (dm.getAssetData("TAIL")->get().size() != 2 || output.find("Skipping row") != std::string::npos) {
+        std::cerr << "ERROR: A load should leave the unterminated last row to refreshData" << std::endl;
+        return;
+    }
+
+    size_t appended = 0;
+    dir.write("TAIL.csv", last.substr(cut, 4), true);
+    capture_output([&] { appended = dm.refreshData(); });
+    if (appended != 0) {
+        std::cerr << "ERROR: refreshData should wait for the newline that ends a row" << std::endl;
+        return;
+    }
+    dir.write("TAIL.csv", last.substr(cut + 4), true);
+    output = capture_output([&] { appended = dm.refreshData(); });
+    const std::vector<PriceBar>& bars = dm.getAssetData("TAIL")->get();
+    const PriceBar& bar = bars.back();
+    if (appended != 1 || bars.size() != 3 || output.find("Warning") != std::string::npos ||
+        bar.timestamp != utc("2025-04-01", "09:32:00") || bar.Open != 12 || bar.Close != 12.25 || bar.Volume != 300) {
+        std::cerr << "ERROR: A row completed after the load should be appended once, as written" << std::endl;
+        return;
+    }
+    std::cout << "A row written across the load and two appends is read once, complete" << std::endl;
+
+    // Appending must not skip a replayed timestamp's remaining ticks (here the second 09:31 bar).
+    ScratchDir repeat("tail_follow_repeat");
+    repeat.write("REP.csv", CSV_HEADER + csv_row("2025-04-01", "09:30:00", 10) + csv_row("2025-04-01", "09:31:00", 11) +
+                                csv_row("2025-04-01", "09:31:00", 12));
+    DataManager follower;
+    capture_output([&] { follower.loadData(repeat.path()); });
+    DataSnapshot snapshot;
+    follower.getNextBars(snapshot);
+    follower.getNextBars(snapshot);
+    repeat.write("REP.csv", csv_row("2025-04-01", "09:32:00", 13), true);
+    capture_output([&] { appended = follower.refreshData(); });
+    const std::vector<double> expected = {12, 13};
+    for (double close : expected) {
+        const PriceBar* bar = follower.getNextBars(snapshot) ? snapshot.get(0) : nullptr; // REP is SymbolId 0
+        if (appended != 1 || !bar || bar->Close != close + 0.25) {
+            std::cerr << "ERROR: The replay should go on with the bar closing at " << close + 0.25 << " after an append" << std::endl;
+            return;
+        }
+    }
+    std::cout << "An append resumes the replay at the next tick, even on a repeated timestamp" << std::endl;
+}
+
+void test_streamed_chunks() {
+    std::cout << "\n=== Testing Streamed Chunk Replay ===" << std::endl;
+
+    ScratchDir dir("streamed_chunks");
+    std::string aaa = CSV_HEADER;
+    std::string bbb = CSV_HEADER;
+    for (int minute = 30; minute < 42; ++minute) {
+        const std::string time = "09:" + std::to_string(minute) + ":00";
+        aaa += csv_row("2025-04-01", time, 10 + minute);
+        bbb += csv_row("2025-04-01", time, 20 + minute);
+    }
+    dir.write("AAA.csv", aaa);
+    dir.write("BBB.csv", bbb);
+
+    DataManager dm;
+    dm.enableStreamingMode(10);
+    bool loaded = false;
+    capture_output([&] { loaded = dm.loadDataWithContinuity(dir.path(), 0, 3); });
+    DataManager firstThree;
+    firstThree.setMaxRowsToLoad(3);
+    capture_output([&] { firstThree.loadData(dir.path()); });
+    size_t ticks = 0;
+    if (!loaded || !same_replay(firstThree, dm, "Replay of the first streamed chunk", ticks) || ticks != 3) {
+        std::cerr << "ERROR: The first streamed chunk should replay its 3 ticks" << std::endl;
+        return;
+    }
+
+    // Each later chunk extends the series, merges only its own 2 x 3 bars
+    // into the timeline however many came before, and continues the replay.
+    DataSnapshot snapshot;
+    for (size_t chunk_start = 3; chunk_start < 12; chunk_start += 3) {
+        capture_output([&] { loaded = dm.loadDataWithContinuity(dir.path(), chunk_start, 3); });
+        if (!loaded || dm.getTimeline().mergedBars() != 6) {
+            std::cerr << "ERROR: The chunk at row " << chunk_start << " should merge its 6 bars, not "
+                      << dm.getTimeline().mergedBars() << std::endl;
+            return;
+        }
+        for (int minute = 30 + static_cast<int>(chunk_start); minute < 33 + static_cast<int>(chunk_start); ++minute) {
+            if (!dm.getNextBars(snapshot) || snapshot.size() != 2 ||
+                dm.getCurrentTime() != utc("2025-04-01", "09:" + std::to_string(minute) + ":00")) {
+                std::cerr << "ERROR: The chunk at row " << chunk_start << " should continue the replay at 09:" << minute << std::endl;
+                return;
+            }
+        }
+    }
+    if (dm.getNextBars(snapshot) || dm.getWarmupData("AAA", 20).size() != 12) {
+        std::cerr << "ERROR: The four chunks together should hold 12 bars per symbol and 12 ticks" << std::endl;
+        return;
+    }
+    std::cout << "Four streamed chunks replay as one continuous 12-tick series, merging 6 bars each" << std::endl;
+}
+
+void test_merge_cursor() {
+    std::cout << "\n=== Testing Streaming Merge Cursor ===" << std::endl;
+
+    DataManager dm;
+    if (!load_sample(dm)) {
+        return;
+    }
+
+    // Streams added in name order get the same SymbolIds as the DataManager
+    MergeCursor cursor;
+    for (const auto& symbol : dm.getAllSymbols()) {
+        cursor.addStream(std::make_unique<VectorBarStream>(symbol, dm.getAssetData(symbol)->get()));
+    }
+
+    size_t ticks = 0;
+    if (same_replay(dm, cursor, "Merge cursor", ticks)) {
+        std::cout << "Merged " << ticks << " ticks from " << cursor.streamCount() << " streams, matching in-memory replay" << std::endl;
+    }
+}
+
+void test_chunked_feed() {
+    std::cout << "\n=== Testing Chunked Feed ===" << std::endl;
+
+    DataManager dm;
+    if (!load_sample(dm)) {
+        return;
+    }
+    // Small chunks, read inline and by a pool with fewer threads than files.
+    for (size_t threads : {1, 2}) {
+        DataManager source;
+        source.setMaxRowsToLoad(1000);
+        source.setLoaderThreads(threads);
+        std::unique_ptr<MergeCursor> feed;
+        capture_output([&] { feed = source.openChunkedFeed(SAMPLE_DATA, 64); });
+        DataManager expected(dm);
+        size_t ticks = 0;
+        if (!feed || !same_replay(expected, *feed, "Chunked feed with " + std::to_string(threads) + " loader threads", ticks)) {
+            return;
+        }
+        std::cout << "Chunked feed with " << threads << " loader threads replayed " << ticks << " ticks like a full load" << std::endl;
+    }
+
+    // A feed dropped mid-replay waits for the chunks its pool is still decoding.
+    DataManager source;
+    source.setLoaderThreads(2);
+    std::unique_ptr<MergeCursor> feed;
+    capture_output([&] { feed = source.openChunkedFeed(SAMPLE_DATA, 16); });
+    DataSnapshot snapshot;
+    for (int i = 0; i < 40 && feed->getNextBars(snapshot); ++i) {}
+    feed.reset();
+}
+
+void test_merge_cursor_equal_timestamps() {
+    std::cout << "\n=== Testing Merge Cursor With Equal Timestamps ===" << std::endl;
+
+    // AAA and BBB tick together at 09:30, 09:31 and 09:33; AAA has two bars at 09:31.
+    ScratchDir dir("equal_timestamps");
+    dir.write("AAA.csv", CSV_HEADER + csv_row("2025-04-01", "09:30:00", 10) + csv_row("2025-04-01", "09:31:00", 11) +
+                             csv_row("2025-04-01", "09:31:00", 11.5) + csv_row("2025-04-01", "09:33:00", 12));
+    dir.write("BBB.csv", CSV_HEADER + csv_row("2025-04-01", "09:30:00", 20) + csv_row("2025-04-01", "09:31:00", 21) +
+                             csv_row("2025-04-01", "09:32:00", 22) + csv_row("2025-04-01", "09:33:00", 23));
+    DataManager dm;
+    if (!dm.loadData(dir.path())) {
+        std::cerr << "ERROR: Could not load " << dir.path() << std::endl;
+        return;
+    }
+
+    // The in-memory replay: one tick per distinct timestamp, plus one for AAA's repeated 09:31 bar.
+    const std::vector<std::pair<std::string, size_t>> expected = {
+        {"09:30:00", 2}, {"09:31:00", 2}, {"09:31:00", 1}, {"09:32:00", 1}, {"09:33:00", 2}};
+    ReplayCursor replay = dm.openReplay();
+    DataSnapshot snapshot;
+    for (size_t tick = 0; tick < expected.size(); ++tick) {
+        if (!replay.getNextBars(snapshot) || replay.getCurrentTime() != utc("2025-04-01", expected[tick].first) ||
+            snapshot.size() != expected[tick].second) {
+            std::cerr << "ERROR: Tick " << tick << " should hold " << expected[tick].second << " bars at "
+                      << expected[tick].first << std::endl;
+            return;
+        }
+    }
+    if (replay.getNextBars(snapshot)) {
+        std::cerr << "ERROR: Replay of equal timestamps has ticks left over" << std::endl;
+    }
+
+    MergeCursor cursor;
+    for (const auto& symbol : dm.getAllSymbols()) {
+        cursor.addStream(std::make_unique<VectorBarStream>(symbol, dm.getAssetData(symbol)->get()));
+    }
+    size_t ticks = 0;
+    if (same_replay(dm, cursor, "Merge cursor with equal timestamps", ticks)) {
+        std::cout << "Merged " << ticks << " ticks with shared and repeated timestamps, matching in-memory replay" << std::endl;
+    }
+}
+
+void test_replay_cursor_independence() {
+    std::cout << "\n=== Testing Independent Replay Cursors ===" << std::endl;
+
+    ScratchDir dir("replay_cursors");
+    std::string aaa = CSV_HEADER;
+    std::string bbb = CSV_HEADER;
+    for (int minute = 30; minute < 36; ++minute) {
+        const std::string time = "09:" + std::to_string(minute) + ":00";
+        aaa += csv_row("2025-04-01", time, 10 + minute);
+        bbb += csv_row("2025-04-01", time, 20 + minute);
+    }
+    dir.write("AAA.csv", aaa);
+    dir.write("BBB.csv", bbb);
+    ScratchDir other("replay_cursors_other");
+    other.write("CCC.csv", CSV_HEADER + csv_row("2025-04-02", "09:30:00", 30));
+
+    // Replays the rest of `cursor`, expecting ticks 09:<first>..09:<last> of both symbols.
+    auto replays = [](ReplayCursor& cursor, int first, int last) {
+        DataSnapshot snapshot;
+        for (int minute = first; minute <= last; ++minute) {
+            if (!cursor.getNextBars(snapshot) || snapshot.size() != 2 ||
+                cursor.getCurrentTime() != utc("2025-04-01", "09:" + std::to_string(minute) + ":00")) {
+                return false;
+            }
+        }
+        return !cursor.getNextBars(snapshot);
+    };
+
+    DataManager dm;
+    capture_output([&] { dm.loadData(dir.path()); });
+    ReplayCursor ahead = dm.openReplay();
+    ReplayCursor fresh = dm.openReplay();
+    DataSnapshot snapshot;
+    ahead.getNextBars(snapshot);
+    ahead.getNextBars(snapshot);
+
+    // Appending copies the dataset the cursors hold; a reload replaces it.
+    dir.write("AAA.csv", csv_row("2025-04-01", "09:36:00", 46), true);
+    size_t appended = 0;
+    capture_output([&] { appended = dm.refreshData(); });
+    if (appended != 1 || dm.getTimeline().size() != 7 || fresh.dataset()->timeline.size() != 6) {
+        std::cerr << "ERROR: refreshData should extend a copy of the dataset the cursors replay" << std::endl;
+        return;
+    }
+    capture_output([&] { dm.loadData(other.path()); });
+    if (!replays(ahead, 32, 35) || !replays(fresh, 30, 35)) {
+        std::cerr << "ERROR: Cursors opened before a refresh and a reload should replay their own data independently" << std::endl;
+        return;
+    }
+
+    // Streamed chunks leave the dataset of an open cursor untouched as well.
+    DataManager streamed;
+    streamed.enableStreamingMode(10);
+    capture_output([&] { streamed.loadDataWithContinuity(dir.path(), 0, 3); });
+    ReplayCursor chunk = streamed.openReplay();
+    const MarketDataset* held = chunk.dataset().get();
+    capture_output([&] { streamed.loadDataWithContinuity(dir.path(), 3, 3); });
+    if (held->findSeries("AAA").size() != 3 || streamed.getTimeline().size() != 6 || !replays(chunk, 30, 32)) {
+        std::cerr << "ERROR: A streamed chunk load should not change the dataset of an open cursor" << std::endl;
+        return;
+    }
+    std::cout << "Cursors keep replaying their own dataset across refreshes, reloads and streamed chunks" << std::endl;
+}
+
 void test_strategy_basic_logic() {
     std::cout << "\n=== Testing Strategy Basic Logic ===" << std::endl;
     
@@ -134,6 +1337,57 @@ void test_timestamp_parsing() {
     }
 }
 
+void test_timestamp_parser() {
+    std::cout << "\n=== Testing Timestamp Parser ===" << std::endl;
+
+    // Seconds since the epoch of `date` `time`, or -1 if the parser rejects it.
+    auto epoch = [](TimestampParser& parser, const std::string& date, const std::string& time) -> long long {
+        std::chrono::system_clock::time_point t;
+        if (!parser.parse(date, time, t)) return -1;
+        return std::chrono::duration_cast<std::chrono::seconds>(t.time_since_epoch()).count();
+    };
+    TimestampParser parser;
+    const std::vector<std::tuple<std::string, std::string, long long>> cases = {
+        {"2024-02-29", "00:00:00", 1709164800}, // Leap year
+        {"2100-02-29", "00:00:00", -1},         // Century, not a leap year
+        {"2024-13-01", "00:00:00", -1},
+        {"2024-01-00", "00:00:00", -1},
+        {"2024-3-5", "9:30:00", 1709631000},    // One-digit month, day and hour
+        {"2024-12-31", "23:59:60", 1735689600}, // Leap second rolls into the next day
+        {"2024-12-31", "23:59:61", -1},
+        {"2024-03-01", "9:5:00", -1},           // Minutes need two digits
+        // Rows sharing a date reuse its cached day; another date of the same
+        // length, valid or not, must not.
+        {"2024-03-01", "09:30:00", 1709285400},
+        {"2024-03-01", "16:00:00", 1709308800},
+        {"2024-02-30", "09:30:00", -1},
+        {"2024-03-02", "09:30:00", 1709371800},
+        {"2024-03-01", "09:30:00", 1709285400},
+    };
+    for (const auto& [date, time, expected] : cases) {
+        const long long parsed = epoch(parser, date, time);
+        if (parsed != expected) {
+            std::cerr << "ERROR: " << date << " " << time << " should parse to " << expected << ", not " << parsed << std::endl;
+            return;
+        }
+    }
+
+    // Wall-clock times at UTC-4 are four hours later in UTC, in the parser and in a load.
+    TimestampParser eastern(std::chrono::hours(-4));
+    ScratchDir dir("timestamp_offset");
+    dir.write("EST.csv", CSV_HEADER + csv_row("2024-04-01", "09:30:00", 10));
+    DataManager dm;
+    dm.setTimestampUtcOffset(std::chrono::hours(-4));
+    capture_output([&] { dm.loadData(dir.path()); });
+    const auto loaded = dm.getAssetData("EST")->get().front().timestamp;
+    if (epoch(eastern, "2024-04-01", "09:30:00") != 1711978200 ||
+        std::chrono::duration_cast<std::chrono::seconds>(loaded.time_since_epoch()).count() != 1711978200) {
+        std::cerr << "ERROR: 09:30 at UTC-4 should be 13:30 UTC" << std::endl;
+        return;
+    }
+    std::cout << cases.size() << " dates and times parsed or rejected as expected, UTC offset applied" << std::endl;
+}
+
 void test_single_strategy_run() {
     std::cout << "\n=== Testing Single Strategy Run ===" << std::endl;
     
@@ -178,7 +1432,31 @@ int main() {
     
     try {
         test_timestamp_parsing();
+        test_timestamp_parser();
+        test_csv_scanner();
         test_data_loading();
+        test_parallel_ranges();
+        test_columnar_storage();
+        test_bar_cache();
+        test_time_window();
+        test_compressed_input();
+        test_bulk_file_reader();
+        test_page_hints();
+        test_symbol_loads();
+        test_compressed_storage();
+        test_compressed_price_modes();
+        test_tick_storage();
+        test_tick_size_inference();
+        test_resampling();
+        test_resampled_load();
+        test_screening_stats();
+        test_resampling_bucket_edges();
+        test_tail_follow();
+        test_merge_cursor();
+        test_chunked_feed();
+        test_streamed_chunks();
+        test_replay_cursor_independence();
+        test_merge_cursor_equal_timestamps();
         test_strategy_basic_logic();
         test_single_strategy_run();
         